@@ -11,11 +11,55 @@
 
 #include "Arduboy.h"
 #include "breakout_bitmaps.h"
+#include "breakout_draw.h"
+#include "breakout_sound.h"
+#include "breakout_script.h"
+#include "breakout_strip.h"
+#include "breakout_tasks.h"
 
+//Uncomment to run the on-device benchmarks instead of the game
+//#define BENCHMARK
+
+//Uncomment to find brick hits by probing the framebuffer around the ball
+//instead of testing every brick's bounds
+//#define FRAMEBUFFER_COLLISION
+
+//Uncomment to wipe the high score table onto the screen a page at a time
+//#define HIGH_SCORE_REVEAL
+
+//Uncomment for the advanced mode, where the brick wall steps down a row
+//at intervals
+//#define DESCENDING_WALL
+
+//Uncomment for the advanced mode, where some brick rows slide sideways
+//and wrap round the screen
+//#define SLIDING_ROWS
+
+//Uncomment to render every screen page by page from a display list
+//instead of drawing it into the framebuffer, which then isn't allocated
+//#define PAGE_STRIP_RENDER
+
+#if defined(FRAMEBUFFER_COLLISION) && defined(PAGE_STRIP_RENDER)
+#error "FRAMEBUFFER_COLLISION needs the bricks drawn in the framebuffer"
+#endif
+
+#if defined(SLIDING_ROWS) && defined(PAGE_STRIP_RENDER)
+#error "SLIDING_ROWS wraps bricks round the screen edge, which display lists can't draw"
+#endif
+
+#ifdef PAGE_STRIP_RENDER
+StripArduboy arduboy; //No screen buffer, frames go out a page at a time
+#else
 Arduboy arduboy;
+#endif
 
 const unsigned int COLUMNS = 13; //Columns of bricks
+#ifdef DESCENDING_WALL
+const unsigned int ROWS = 8;     //Rows of bricks, room for the wall to come down
+#else
 const unsigned int ROWS = 4;     //Rows of bricks
+#endif
+const byte START_ROWS = 4;       //Rows a new wall is dealt
 int dx = -1;        //Initial movement of ball
 int dy = -1;        //Initial movement of ball
 int xb;           //Balls starting possition
@@ -23,18 +67,16 @@ int yb;           //Balls starting possition
 boolean released;     //If the ball has been released by the player
 boolean paused = false;   //If the game has been paused
 byte xPaddle;       //X position of paddle
-boolean isHit[ROWS][COLUMNS];   //Array of if bricks are hit or not
+byte paddleWidth = 11;  //Width of paddle, wider with the power-up
 boolean bounced=false;  //Used to fix double bounce glitch
 byte lives = 3;       //Amount of lives
 byte level = 1;       //Current level
 unsigned int score=0;   //Score for the game
-unsigned int brickCount;  //Amount of bricks hit
 byte pad,pad2,pad3;     //Button press buffer used to stop pause repeating
 byte oldpad,oldpad2,oldpad3;
 char text[16];      //General string buffer
 boolean start=false;    //If in menu or in game
 boolean initialDraw=false;//If the inital draw has happened
-char initials[3];     //Initials used in high score
 
 //Ball Bounds used in collision detection
 byte leftBall;
@@ -50,28 +92,258 @@ byte bottomBrick;
 
 byte tick;
 
+const unsigned int FULL_ROW = (1 << COLUMNS) - 1; //Row mask of a new wall
+const byte BRICKS_BOTTOM = 2 + 6 * ROWS; //First pixel row below the wall
+const byte NO_BRICK = 0xFF;              //No live brick was found
+
+//Ball dx after a paddle bounce, indexed by xb - xPaddle + 1. Same as
+//(xb - (xPaddle + 6)) / 3 without a software divide on the AVR
+PROGMEM const signed char PADDLE_SPIN[] =
+{
+  -2, -2, -1, -1, -1, 0, 0, 0, 0, 0, 1, 1, 1, 2
+};
+
+//Brick hits found by collision, applied once per frame by applyBrickHits()
+//Each event packs the row and column as rrrcccc, plus HIT_TOUGH
+const byte HIT_VERTICAL = 1;    //Ball bounced off the top or bottom
+const byte HIT_HORIZONTAL = 2;  //Ball bounced off a side
+const byte HIT_SHOT = 3;        //A laser shot, which never moves the ball
+const byte HIT_TOUGH = 0x80;    //Brick lost its extra hit and still stands
+const byte HIT_QUEUE_SIZE = 16; //Applied early if more are found in one frame
+//Tones owed by the queued hits, the lowest bit set is played
+const byte SOUND_BLAST = 1;     //A brick went in an explosion
+const byte SOUND_BOUNCE = 2;    //The ball broke a brick and bounced
+const byte SOUND_TOUGH = 4;     //A tough brick took a hit
+const byte SOUND_SOLID = 8;     //A brick that can't break was hit
+
+//Explosive bricks take their neighbours with them, and explosive
+//neighbours carry the blast on. Each explosive brick queues its blast
+//once, and only BLASTS_PER_FRAME go off a frame, so a chain across the
+//whole wall spreads over several frames at a bounded cost per frame
+//Kept constexpr, as well as in flash, so the blast queue size is checked
+PROGMEM constexpr unsigned int EXPLOSIVE[START_ROWS] = {0x0000, 0x0842, 0x0108, 0x0000};
+const byte BLAST_QUEUE = 8;     //Power of two, at least the explosive bricks
+const byte BLASTS_PER_FRAME = 2;
+
+//Indestructible bricks only ever bounce the ball. Tough bricks take a
+//second hit to break, the first just turns them into normal bricks.
+PROGMEM constexpr unsigned int SOLID[START_ROWS] = {0x0000, 0x0000, 0x0000, 0x1041};
+PROGMEM constexpr unsigned int TOUGH[START_ROWS] = {0x0AAA, 0x0000, 0x0000, 0x0000};
+
+#ifdef DESCENDING_WALL
+const unsigned int DESCEND_STEPS = 600; //Physics steps between wall steps
+#endif
+
+#ifdef SLIDING_ROWS
+//Pixels a row moves each slide, 0 for rows that stay put. A row is a
+//ring of brick slots, so one that slides a whole slot rotates its masks
+PROGMEM const signed char SLIDE[START_ROWS] = {0, 1, -1, 0};
+const byte SLIDE_STEPS = 8;             //Physics steps between slides
+const byte RING_WIDTH = 10 * COLUMNS;   //Pixels round a sliding row
+#endif
+
+constexpr byte bitCount(unsigned int mask)
+{
+  return mask ? (mask & 1) + bitCount(mask >> 1) : 0;
+}
+static_assert(bitCount(EXPLOSIVE[0]) + bitCount(EXPLOSIVE[1]) +
+              bitCount(EXPLOSIVE[2]) + bitCount(EXPLOSIVE[3]) <= BLAST_QUEUE,
+              "more explosive bricks than the blast queue holds");
+
+//Power-ups dropped by broken bricks, falling in a fixed pool of slots.
+//Lists link by slot + 1, so a zeroed PlayState is an empty pool
+const byte DROP_POOL = 4;       //Most power-ups falling at once
+const byte DROP_EVERY = 6;      //Bricks broken for each power-up dropped
+const byte DROP_WIDE = 0;       //Paddle grows to WIDE_PADDLE
+const byte DROP_SLOW = 1;       //Ball moves every other step for a while
+const byte DROP_MULTI = 2;      //Two more balls split off the first
+const byte DROP_LASER = 3;      //FIRE shoots from the paddle LASER_PAIRS times
+const byte DROP_TYPES = 4;
+PROGMEM const byte DROP_WIDTH[] = {5, 3, 2, 1};
+PROGMEM const byte DROP_HEIGHT[] = {2, 3, 2, 4};
+const byte EXTRA_BALLS = 2;     //Balls in play besides the first
+const byte PADDLE_WIDTH = 11;
+const byte WIDE_PADDLE = 17;
+const unsigned int SLOW_STEPS = 600;  //Physics steps the ball is slow for
+const byte LASER_PAIRS = 10;    //Pairs of shots one laser power-up gives
+const byte SHOT_MAX = 6;        //Most laser shots in flight at once
+const byte SHOT_LENGTH = 3;
+const byte SHOT_SPEED = 2;      //Pixels a shot climbs each physics step
+
+//HUD parts waiting to be redrawn by the HUD task
+const byte HUD_LIVES = 1;
+const byte HUD_SCORE = 2;
+
+//Game phases. State that only one phase needs lives in the PhaseState
+//union, which enterPhase() clears on every transition, so peak SRAM is
+//the largest phase rather than the sum of them
+const byte PHASE_TITLE = 0;
+const byte PHASE_PLAY = 1;
+const byte PHASE_INITIALS = 2;
+
+struct TitleState     //Title screen and high score table
+{
+  unsigned int scores[10]; //Stored as two bytes each
+  char initials[10][3];    //High score table read from EEPROM
+  boolean loaded;          //If the table has been read this phase
+};
+
+struct PlayState      //A game in progress
+{
+  unsigned int bricks[ROWS];     //Bit n set while the brick in column n stands
+  unsigned int explosive[ROWS];  //Bit n set if the brick in column n explodes
+  unsigned int solid[ROWS];      //Bit n set if the brick in column n can't break
+  unsigned int tough[ROWS];      //Bit n set while the brick needs one more hit
+  unsigned int slowSteps;        //Physics steps left of slow ball
+#ifdef DESCENDING_WALL
+  unsigned int descendSteps;     //Physics steps until the wall steps down
+#endif
+  byte hitQueue[HIT_QUEUE_SIZE]; //Brick hits waiting for applyBrickHits()
+  byte hitCount;
+  byte hitSounds;     //SOUND_* bits owed by the queued hits
+  byte hudDirty;      //HUD_* bits the HUD task still has to draw
+  byte dropX[DROP_POOL];    //Falling power-ups, one slot per index
+  byte dropY[DROP_POOL];
+  byte dropType[DROP_POOL];
+  byte dropNext[DROP_POOL]; //Next slot + 1 in the live or free list
+  byte dropLive;            //First falling slot + 1, 0 for none
+  byte dropFree;            //First freed slot + 1, 0 for none
+  byte dropUsed;            //Slots handed out at least once
+  byte dropTick;            //Drops fall on every other physics step
+  byte bricksToDrop;        //Bricks broken since the last drop
+  byte nextDrop;            //Type of the next drop
+  byte extraX[EXTRA_BALLS]; //Multi-ball balls besides the first
+  byte extraY[EXTRA_BALLS];
+  signed char extraDx[EXTRA_BALLS];
+  signed char extraDy[EXTRA_BALLS];
+  byte extraCount;
+  byte shotX[SHOT_MAX];     //Laser shots in flight
+  byte shotY[SHOT_MAX];     //Top pixel of the shot
+  byte shotColumn[SHOT_MAX];//Brick column the shot is under, or NO_BRICK
+  byte shotCount;
+  byte laserPairs;          //Shots left from the laser power-up
+  boolean laserHeld;        //FIRE was down last frame
+  byte blastQueue[BLAST_QUEUE]; //Exploded bricks as rrrcccc, oldest first
+  byte blastHead;
+  byte blastCount;
+#ifdef SLIDING_ROWS
+  byte rowX[ROWS];              //Pixels the row has slid right, 0 to 9
+  signed char rowSlide[ROWS];   //Pixels the row moves each slide
+  byte slideSteps;              //Physics steps since the last slide
+#endif
+};
+
+struct InitialsState  //Entering initials for a new high score
+{
+  char initials[3];   //Initials used in high score
+  char index;         //Initial being edited
+  byte held;          //Buttons down last frame
+  byte repeatFrames;  //Frames until held buttons repeat
+};
+
+//Phase budgets, so growth in one phase shows up at compile time. Each
+//is the bytes and words of the device layout, with words scaled by the
+//build's int and a phase with words rounded up to the int's alignment.
+//Words come first in every phase, so this is exact on the device and on
+//the host.
+constexpr unsigned int phaseBudget(unsigned int bytes, unsigned int words)
+{
+  return words ? (bytes + words * sizeof(unsigned int) + alignof(unsigned int) - 1) /
+                 alignof(unsigned int) * alignof(unsigned int) : bytes;
+}
+
+#ifdef DESCENDING_WALL
+const byte PLAY_WORDS = 4 * ROWS + 2; //Brick masks, slow ball and descent counters
+#else
+const byte PLAY_WORDS = 4 * ROWS + 1; //Brick masks and the slow ball counter
+#endif
+#ifdef SLIDING_ROWS
+const byte PLAY_BYTES = 81 + 2 * ROWS + 1; //Offset and speed for every row, and the slide counter
+#else
+const byte PLAY_BYTES = 81;
+#endif
+
+static_assert(sizeof(TitleState) <= phaseBudget(31, 10), "title state over budget");
+static_assert(sizeof(PlayState) <= phaseBudget(PLAY_BYTES, PLAY_WORDS), "play state over budget");
+static_assert(sizeof(InitialsState) <= phaseBudget(6, 0), "initials state over budget");
+
+union PhaseState
+{
+  TitleState title;
+  PlayState play;
+  InitialsState entry;
+};
+
+PhaseState phase;
+byte gamePhase;       //Phase whose state is in phase
+
+//Frame rate tiers, stepped between as the measured frame cost changes
+PROGMEM const byte FRAME_TIERS[] = {30, 45, 60, 90};
+const byte TIER_COUNT = sizeof(FRAME_TIERS);
+//Frame period in us for each tier, so the deadline needs no divide
+PROGMEM const unsigned int FRAME_PERIODS[] = {33333, 22222, 16667, 11111};
+static_assert(sizeof(FRAME_PERIODS) / sizeof(FRAME_PERIODS[0]) == TIER_COUNT, "frame period missing for a tier");
+const byte START_TIER = 2;    //60fps
+const byte PHYSICS_RATE = 60; //Physics steps per second, speeds are tuned for this
+const int PHYSICS_STEP = 1000;//Accumulator units in one physics step (ms * PHYSICS_RATE)
+const byte MAX_CATCHUP = 4;   //Most physics steps run in a single frame
+const byte MAX_ELAPSED = 100; //Longest frame time (ms) fed to the accumulator
+const byte LOAD_HIGH = 90;    //CPU load (%) that steps the frame rate down
+const byte LOAD_LOW = 50;     //CPU load (%) that steps the frame rate up
+const byte FRAMES_HIGH = 8;   //Frames over LOAD_HIGH before stepping down
+const byte FRAMES_LOW = 120;  //Frames under LOAD_LOW before stepping up
+byte frameTier = START_TIER;  //Current index into FRAME_TIERS
+byte highLoadFrames;          //Consecutive frames over LOAD_HIGH
+byte lowLoadFrames;           //Consecutive frames under LOAD_LOW
+unsigned long physicsTime;    //millis() when the accumulator was last fed
+unsigned int physicsAccum;    //Physics time owed, in ms * PHYSICS_RATE
+
+//UI text. Kept in flash so none of it is copied into SRAM at startup;
+//draw it with drawTextP() and format with sprintf_P()
+PROGMEM const char STR_HELLO[] = "Hello World!";
+PROGMEM const char STR_ARDUBOY[] = "ARDUBOY";
+PROGMEM const char STR_TITLE[] = "ARAKNOID";
+PROGMEM const char STR_PRESS_FIRE[] = "PRESS FIRE!";
+PROGMEM const char STR_HIGH_SCORES[] = "HIGH SCORES";
+PROGMEM const char STR_HIGH_SCORE[] = "HIGH SCORE";
+PROGMEM const char STR_PAUSE[] = "PAUSE";
+PROGMEM const char STR_GAME[] = "Game";
+PROGMEM const char STR_OVER[] = "Over";
+PROGMEM const char FMT_LIVES[] = "LIVES:%u";
+PROGMEM const char FMT_SCORE[] = "SCORE:%u";
+PROGMEM const char FMT_RANK[] = "%2d";
+PROGMEM const char FMT_ENTRY[] = "%c%c%c %u";
+PROGMEM const char FMT_NUMBER[] = "%u";
+
 #include "pins_arduino.h" // Arduino pre-1.0 needs this
 
-void intro()
+//Scrolls the logo down, then waits out the intro tune
+byte introSequence(Script *s)
 {
-  for(int i = -8; i < 28; i = i + 2)
+  SCRIPT_BEGIN(s);
+  for(s->count = -8; s->count < 28; s->count = s->count + 2)
   {
+#ifdef PAGE_STRIP_RENDER
+    stripBegin();
+    stripTextP(46, s->count, STR_ARDUBOY);
+    stripRender(0, HEIGHT / 8 - 1, 0);
+#else
     arduboy.clear();
-    arduboy.setCursor(46, i);
-    arduboy.print("ARDUBOY");
+    drawTextP(46, s->count, STR_ARDUBOY);
     arduboy.display();
+#endif
+    SCRIPT_YIELD(s);
   }
 
-  arduboy.tunes.tone(987, 160);
-  delay(160);
-  arduboy.tunes.tone(1318, 400);
-  delay(2000);
+  playScore(introScore);
+  SCRIPT_WAIT_MS(s, 2160);
+  SCRIPT_END(s);
 }
 
 void movePaddle()
 {
   //Move right
-  if(xPaddle < WIDTH - 12)
+  if(xPaddle < WIDTH - paddleWidth - 1)
   {
     if (arduboy.pressed(RIGHT_BUTTON))
     {
@@ -89,142 +361,305 @@ void movePaddle()
   }
 }
 
-void moveBall()
+//Moves the ball one physics step along dx, dy
+void stepBall()
 {
-  tick++;
-  if(released)
+  if (abs(dx)==2) {
+    xb += dx >> 1;
+    // 2x speed is really 1.5 speed
+    if ((tick & 1) == 0)
+      xb += dx >> 1;
+  } else {
+    xb += dx;
+  }
+  yb=yb + dy;
+}
+
+//Horizontal speed for a ball hitting the paddle at offset 0-13
+int paddleSpin(byte offset)
+{
+  return (signed char)pgm_read_byte(&PADDLE_SPIN[offset]);
+}
+
+//Position of screen x along row, where brick slots start every 10
+//pixels from 0. Sliding rows are offset, and wrap round at RING_WIDTH.
+byte ringX(byte row, byte x)
+{
+#ifdef SLIDING_ROWS
+  if (x < phase.play.rowX[row])
   {
-    //Move ball
-    if (abs(dx)==2) {
-      xb += dx/2;
-      // 2x speed is really 1.5 speed
-      if (tick%2==0)
-        xb += dx/2;
-    } else {
-      xb += dx;
-    }
-    yb=yb + dy;
+    return x + RING_WIDTH - phase.play.rowX[row];
+  }
+  return x - phase.play.rowX[row];
+#else
+  return x;
+#endif
+}
 
-    //Set bounds
-    leftBall = xb;
-    rightBall = xb + 2;
-    topBall = yb;
-    bottomBall = yb + 2;
+//Screen x of the left edge of a brick, which can wrap off the right
+//edge of the screen in a sliding row
+byte brickX(byte row, byte column)
+{
+#ifdef SLIDING_ROWS
+  byte x = 10*column + phase.play.rowX[row];
+  return (x >= RING_WIDTH) ? x - RING_WIDTH : x;
+#else
+  return 10*column;
+#endif
+}
 
-    //Bounce off top edge
-    if (yb <= 0)
-    {
-      yb = 2;
-      dy = -dy;
-      arduboy.tunes.tone(523, 250);
-    }
+//Column whose brick covers screen x in row, or NO_BRICK in a gap
+byte columnAt(byte row, byte x)
+{
+  byte ring = ringX(row, x);
+  //ring / 10 by multiply and shift, exact over the wall
+  byte column = (ring * 205) >> 11;
 
-    //Lose a life if bottom edge hit
-    if (yb >= 64)
-    {
-      arduboy.drawRect(xPaddle, 63, 11, 1, 0);
-      xPaddle = 54;
-      yb=60;
-      released = false;
-      lives--;
-      drawLives();
-      arduboy.tunes.tone(175, 250);
-      if (random(0, 2) == 0)
-      {
-        dx = 1;
-      }
-      else
-      {
-        dx = -1;
-      }
-    }
+  return (ring - 10*column < 8) ? column : NO_BRICK;
+}
+
+#ifdef FRAMEBUFFER_COLLISION
+//Returns the live brick drawn at x, y as rrrcccc, or NO_BRICK
+byte brickAt(int x, int y)
+{
+  byte row, column;
+
+  if (x < 0 || x >= WIDTH || y < 2 || y >= BRICKS_BOTTOM)
+  {
+    return NO_BRICK;
+  }
+  if (!(frameBuffer[(y >> 3) * WIDTH + x] & (1 << (y & 7))))
+  {
+    return NO_BRICK;
+  }
+
+  //x / 10 and (y - 2) / 6 by multiply and shift, exact over the wall
+  row = ((y - 2) * 43) >> 8;
+  column = (ringX(row, x) * 205) >> 11;
+  if (!(phase.play.bricks[row] & (1 << column)))
+  {
+    //Still drawn until applyBrickHits() erases it this frame
+    return NO_BRICK;
+  }
+  return (row << 4) | column;
+}
+
+//Brick collision in constant time: the ball is already erased, so any
+//lit pixel on its leading row or column inside the wall is a brick.
+//The two share the leading corner, so each side is probed without it
+//first, and a brick found only at the corner is judged by whether it
+//was already level with the ball before this step.
+void collideFramebuffer()
+{
+  int leadX = (dx < 0) ? xb : xb + 1;
+  int leadY = (dy < 0) ? yb : yb + 1;
+  int trailX = (dx < 0) ? xb + 1 : xb;
+  int trailY = (dy < 0) ? yb + 1 : yb;
+  byte brick;
+  byte normal;
+
+  if (yb >= BRICKS_BOTTOM)
+  {
+    return;
+  }
+
+  //Horizontal collision, the side of a brick. Bricks are hollow, so a
+  //ball moving two pixels a step also looks at the edge it stepped over.
+  normal = HIT_HORIZONTAL;
+  brick = brickAt(leadX, trailY);
+  if (brick == NO_BRICK && (dx == 2 || dx == -2))
+  {
+    brick = brickAt(leadX - dx / 2, trailY);
+  }
+
+  //Vertical collision, only with the leading column clear
+  if (brick == NO_BRICK)
+  {
+    normal = HIT_VERTICAL;
+    brick = brickAt(trailX, leadY);
+  }
 
-    //Bounce off left side
-    if (xb <= 0)
+  //Corner collision
+  if (brick == NO_BRICK)
+  {
+    brick = brickAt(leadX, leadY);
+    if (brickAt(leadX, leadY - dy) != NO_BRICK)
     {
-      xb = 2;
-      dx = -dx;
-      arduboy.tunes.tone(523, 250);
+      normal = HIT_HORIZONTAL;
     }
+  }
 
-    //Bounce off right side
-    if (xb >= WIDTH - 2)
-    {
-      xb = WIDTH - 4;
-      dx = -dx;
-      arduboy.tunes.tone(523, 250);
+  if (brick == NO_BRICK)
+  {
+    return;
+  }
+
+  if (normal == HIT_VERTICAL)
+  {
+    dy =- dy;
+    yb += dy;
+  }
+  else
+  {
+    dx =- dx;
+    xb += dx;
+  }
+  hitBrick(brick >> 4, brick & 0x0F, normal);
+}
+#endif
+
+//Moves the ball in xb, yb, dx, dy one step, bouncing it off the walls,
+//paddle and bricks. Returns false if it fell out of the bottom.
+boolean bounceBall()
+{
+  stepBall();
+
+  //Set bounds
+  leftBall = xb;
+  rightBall = xb + 2;
+  topBall = yb;
+  bottomBall = yb + 2;
+
+  //Bounce off top edge
+  if (yb <= 0)
+  {
+    yb = 2;
+    dy = -dy;
+    playTone(TONE_523, 250);
+  }
+
+  //Fell out of the bottom
+  if (yb >= 64)
+  {
+    return false;
+  }
+
+  //Bounce off left side
+  if (xb <= 0)
+  {
+    xb = 2;
+    dx = -dx;
+    playTone(TONE_523, 250);
+  }
+
+  //Bounce off right side
+  if (xb >= WIDTH - 2)
+  {
+    xb = WIDTH - 4;
+    dx = -dx;
+    playTone(TONE_523, 250);
+  }
+
+  //Bounce off paddle
+  if (xb+1>=xPaddle && xb<=xPaddle+paddleWidth+1 && yb+2>=63 && yb<=64)
+  {
+    dy = -dy;
+    dx = paddleSpin(paddleOffset()); //Applies spin on the ball
+    // prevent straight bounce
+    if (dx == 0) {
+      dx = (tick & 1) ? 1 : -1;
     }
+    playTone(TONE_200, 250);
+  }
 
-    //Bounce off paddle
-    if (xb+1>=xPaddle && xb<=xPaddle+12 && yb+2>=63 && yb<=64)
+  //Bounce off Bricks
+#ifdef FRAMEBUFFER_COLLISION
+  collideFramebuffer();
+#else
+#ifdef SLIDING_ROWS
+  byte screenLeft = leftBall;
+#endif
+  for (byte row = 0; row < ROWS; row++)
+  {
+    //Rows clear of the ball or of bricks can be passed over whole
+    if (phase.play.bricks[row] == 0 || topBall > 6 * row + 7 || bottomBall < 6 * row + 1)
     {
-      dy = -dy;
-      dx = ((xb-(xPaddle+6))/3); //Applies spin on the ball
-      // prevent straight bounce
-      if (dx == 0) {
-        dx = (random(0,2) == 1) ? 1 : -1;
-      }
-      arduboy.tunes.tone(200, 250);
+      continue;
     }
-
-    //Bounce off Bricks
-    for (byte row = 0; row < ROWS; row++)
+#ifdef SLIDING_ROWS
+    //Bricks are tested where they sit in the row's ring, so a sliding
+    //row only costs moving the ball into it
+    leftBall = ringX(row, screenLeft);
+    rightBall = leftBall + 2;
+#endif
+    for (byte column = 0; column < COLUMNS; column++)
     {
-      for (byte column = 0; column < COLUMNS; column++)
+      if (phase.play.bricks[row] & (1 << column))
       {
-        if (!isHit[row][column])
+        //Sets Brick bounds
+        leftBrick = 10 * column;
+        rightBrick = 10 * column + 10;
+        topBrick = 6 * row + 1;
+        bottomBrick = 6 * row + 7;
+
+        //If A collison has occured
+        if (topBall <= bottomBrick && bottomBall >= topBrick &&
+            leftBall <= rightBrick && rightBall >= leftBrick)
         {
-          //Sets Brick bounds
-          leftBrick = 10 * column;
-          rightBrick = 10 * column + 10;
-          topBrick = 6 * row + 1;
-          bottomBrick = 6 * row + 7;
-
-          //If A collison has occured
-          if (topBall <= bottomBrick && bottomBall >= topBrick &&
-              leftBall <= rightBrick && rightBall >= leftBrick)
-          {
-            Score();
-            brickCount++;
-            isHit[row][column] = true;
-            arduboy.drawRect(10*column, 2+6*row, 8, 4, 0);
+          byte normal = 0;
 
-            //Vertical collision
-            if (bottomBall > bottomBrick || topBall < topBrick)
+          //Vertical collision
+          if (bottomBall > bottomBrick || topBall < topBrick)
+          {
+            //Only bounce once each ball move
+            if(!bounced)
             {
-              //Only bounce once each ball move
-              if(!bounced)
-              {
-                dy =- dy;
-                yb += dy;
-                bounced = true;
-                arduboy.tunes.tone(261, 250);
-              }
+              dy =- dy;
+              yb += dy;
+              bounced = true;
+              normal = HIT_VERTICAL;
             }
+          }
 
-            //Hoizontal collision
-            if (leftBall < leftBrick || rightBall > rightBrick)
+          //Hoizontal collision
+          if (leftBall < leftBrick || rightBall > rightBrick)
+          {
+            //Only bounce once brick each ball move
+            if(!bounced)
             {
-              //Only bounce once brick each ball move
-              if(!bounced)
-              {
-                dx =- dx;
-                xb += dx;
-                bounced = true;
-                arduboy.tunes.tone(261, 250);
-              }
+              dx =- dx;
+              xb += dx;
+              bounced = true;
+              normal = HIT_HORIZONTAL;
             }
           }
+
+          hitBrick(row, column, normal);
         }
       }
     }
-    //Reset Bounce
-    bounced = false;
+  }
+#endif
+  //Reset Bounce
+  bounced = false;
+  return true;
+}
+
+void moveBall()
+{
+  tick++;
+  if(released)
+  {
+    if (bounceBall())
+    {
+      return;
+    }
+
+    //Another ball from multi-ball carries on in place of a lost one
+    if (phase.play.extraCount > 0)
+    {
+      swapExtraBall(phase.play.extraCount - 1);
+      phase.play.extraCount--;
+      return;
+    }
+
+    //Lose a life if bottom edge hit
+    loseLife();
   }
   else
   {
     //Ball follows paddle
-    xb=xPaddle + 5;
+    xb=xPaddle + (paddleWidth >> 1);
 
     //Release ball if FIRE pressed
     pad3 = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
@@ -233,7 +668,7 @@ void moveBall()
       released=true;
 
       //Apply random direction to ball on release
-      if (random(0, 2) == 0)
+      if (tick & 1)
       {
         dx = 1;
       }
@@ -248,266 +683,1398 @@ void moveBall()
   }
 }
 
-void drawBall()
+//Takes a life and puts the ball back on the paddle
+void loseLife()
+{
+  plotPaddle(0);
+  xPaddle = 54;
+  paddleWidth = PADDLE_WIDTH;
+  phase.play.slowSteps = 0;
+  phase.play.laserPairs = 0;
+  yb=60;
+  released = false;
+  lives--;
+  phase.play.hudDirty |= HUD_LIVES;
+  playTone(TONE_175, 250);
+  if (tick & 1)
+  {
+    dx = 1;
+  }
+  else
+  {
+    dx = -1;
+  }
+}
+
+#ifdef DESCENDING_WALL
+//Steps the wall down a row. The masks rotate down a slot with the top
+//one left empty, and the pixels move with them, so no brick is redrawn.
+//Breakable bricks pushed out of the last slot cost a life.
+void descendWall()
+{
+  const byte last = ROWS - 1;
+  boolean overrun = (phase.play.bricks[last] & ~phase.play.solid[last]) != 0;
+
+  for (byte row = last; row > 0; row--)
+  {
+    phase.play.bricks[row] = phase.play.bricks[row - 1];
+    phase.play.explosive[row] = phase.play.explosive[row - 1];
+    phase.play.solid[row] = phase.play.solid[row - 1];
+    phase.play.tough[row] = phase.play.tough[row - 1];
+#ifdef SLIDING_ROWS
+    phase.play.rowX[row] = phase.play.rowX[row - 1];
+    phase.play.rowSlide[row] = phase.play.rowSlide[row - 1];
+#endif
+  }
+  phase.play.bricks[0] = 0;
+  phase.play.explosive[0] = 0;
+  phase.play.solid[0] = 0;
+  phase.play.tough[0] = 0;
+#ifdef SLIDING_ROWS
+  phase.play.rowX[0] = 0;
+  phase.play.rowSlide[0] = 0;
+#endif
+
+  //Pending blasts follow their bricks, or go with the last row
+  byte blasts[BLAST_QUEUE];
+  byte kept = 0;
+  for (byte i = 0; i < phase.play.blastCount; i++)
+  {
+    byte blast = phase.play.blastQueue[(phase.play.blastHead + i) & (BLAST_QUEUE - 1)];
+    if ((blast >> 4) < last)
+    {
+      blasts[kept++] = blast + 0x10;
+    }
+  }
+  memcpy(phase.play.blastQueue, blasts, kept);
+  phase.play.blastHead = 0;
+  phase.play.blastCount = kept;
+
+#ifndef PAGE_STRIP_RENDER
+  shiftRowsDown(2, BRICKS_BOTTOM - 1, 6);
+#endif
+  if (overrun)
+  {
+    //drawBall() has everything in flight off the screen at this point
+    resetPowerUps();
+    loseLife();
+  }
+}
+#endif
+
+#ifdef SLIDING_ROWS
+//Rotates a row mask a slot right for by 1, or left for by -1
+unsigned int rotateRow(unsigned int mask, signed char by)
+{
+  if (by > 0)
+  {
+    return ((mask << 1) | (mask >> (COLUMNS - 1))) & FULL_ROW;
+  }
+  return (mask >> 1) | ((mask & 1) << (COLUMNS - 1));
+}
+
+//Moves each sliding row along a pixel. Once a row has moved a whole
+//slot its masks rotate and its offset starts over, so collision only
+//ever adds an offset under 10. Only the bands of rows that moved are
+//redrawn.
+void slideRows()
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    signed char slide = phase.play.rowSlide[row];
+    if (slide == 0)
+    {
+      continue;
+    }
+
+    signed char x = phase.play.rowX[row] + slide;
+    signed char by = 0;
+    if (x >= 10)
+    {
+      x -= 10;
+      by = 1;
+    }
+    else if (x < 0)
+    {
+      x += 10;
+      by = -1;
+    }
+    phase.play.rowX[row] = x;
+
+    if (by)
+    {
+      phase.play.bricks[row] = rotateRow(phase.play.bricks[row], by);
+      phase.play.explosive[row] = rotateRow(phase.play.explosive[row], by);
+      phase.play.solid[row] = rotateRow(phase.play.solid[row], by);
+      phase.play.tough[row] = rotateRow(phase.play.tough[row], by);
+
+      //Pending blasts in the row follow their bricks round
+      for (byte i = 0; i < phase.play.blastCount; i++)
+      {
+        byte *blast = &phase.play.blastQueue[(phase.play.blastHead + i) & (BLAST_QUEUE - 1)];
+        if ((*blast >> 4) == row)
+        {
+          byte column = (*blast & 0x0F) + by;
+          if (column == COLUMNS)
+          {
+            column = 0;
+          }
+          else if (column == 0xFF)
+          {
+            column = COLUMNS - 1;
+          }
+          *blast = (row << 4) | column;
+        }
+      }
+    }
+
+    if (phase.play.bricks[row])
+    {
+      fillRectUnchecked(0, 2+6*row, WIDTH, 4, 0);
+      for (byte column = 0; column < COLUMNS; column++)
+      {
+        if (phase.play.bricks[row] & (1 << column))
+        {
+          plotBrick(row, column, 1);
+        }
+      }
+    }
+  }
+}
+#endif
+
+void drawBall(byte steps)
 {
   // arduboy.setCursor(0,0);
   // arduboy.print(arduboy.cpuLoad());
   // arduboy.print("  ");
-  arduboy.drawPixel(xb,   yb,   0);
-  arduboy.drawPixel(xb+1, yb,   0);
-  arduboy.drawPixel(xb,   yb+1, 0);
-  arduboy.drawPixel(xb+1, yb+1, 0);
+  //Everything that moves comes off first, so collision only sees bricks
+  plotDrops();
+  plotShots(0);
+  plotExtraBalls(0);
+  plotBall(0);
+  repairBricks(xb, yb);
+  for (byte i = 0; i < phase.play.extraCount; i++)
+  {
+    repairBricks(phase.play.extraX[i], phase.play.extraY[i]);
+  }
 
-  moveBall();
+#ifdef DESCENDING_WALL
+  //The wall only comes down while the ball is in play
+  if (released)
+  {
+    if (phase.play.descendSteps > steps)
+    {
+      phase.play.descendSteps -= steps;
+    }
+    else
+    {
+      phase.play.descendSteps = DESCEND_STEPS;
+      descendWall();
+    }
+  }
+#endif
+#ifdef SLIDING_ROWS
+  phase.play.slideSteps += steps;
+  if (phase.play.slideSteps >= SLIDE_STEPS)
+  {
+    phase.play.slideSteps -= SLIDE_STEPS;
+    slideRows();
+  }
+#endif
+
+  fireLaser();
+  for (byte i = 0; i < steps; i++)
+  {
+    //A slow ball sits out every other step
+    if (phase.play.slowSteps == 0 || (--phase.play.slowSteps & 1) == 0)
+    {
+      moveBall();
+      moveExtraBalls();
+    }
+    moveShots();
+    moveDrops();
+  }
+  spreadBlasts();
+  applyBrickHits();
 
-  arduboy.drawPixel(xb,   yb,   1);
-  arduboy.drawPixel(xb+1, yb,   1);
-  arduboy.drawPixel(xb,   yb+1, 1);
-  arduboy.drawPixel(xb+1, yb+1, 1);
+  plotBall(1);
+  plotExtraBalls(1);
+  plotShots(1);
+  plotDrops();
 }
 
-void drawPaddle()
+void drawPaddle(byte steps)
 {
-  arduboy.drawRect(xPaddle, 63, 11, 1, 0);
-  movePaddle();
-  arduboy.drawRect(xPaddle, 63, 11, 1, 1);
+  plotPaddle(0);
+  for (byte i = 0; i < steps; i++)
+  {
+    movePaddle();
+  }
+  plotPaddle(1);
 }
 
-void drawLives()
+//The plot functions keep the framebuffer in step with the game. The
+//page strip renderer draws each frame from the game state instead.
+//Physics keeps all of these on screen, so they skip clipping.
+void plotBall(byte color)
 {
-  sprintf(text, "LIVES:%u", lives);
-  arduboy.setCursor(0, 90);
-  arduboy.print(text);
+#ifndef PAGE_STRIP_RENDER
+  drawSpriteShifted(xb, yb, ballShifted, color);
+#endif
 }
 
-void drawGameOver()
+void plotPaddle(byte color)
 {
-  arduboy.drawPixel(xb,   yb,   0);
-  arduboy.drawPixel(xb+1, yb,   0);
-  arduboy.drawPixel(xb,   yb+1, 0);
-  arduboy.drawPixel(xb+1, yb+1, 0);
-  arduboy.setCursor(52, 42);
-  arduboy.print( "Game");
-  arduboy.setCursor(52, 54);
-  arduboy.print("Over");
-  arduboy.display();
-  delay(4000);
+#ifndef PAGE_STRIP_RENDER
+  drawHLineUnchecked(xPaddle, 63, paddleWidth, color);
+#endif
 }
 
-void pause()
+void plotExtraBalls(byte color)
 {
-  paused = true;
-  //Draw pause to the screen
-  arduboy.setCursor(52, 45);
-  arduboy.print("PAUSE");
-  arduboy.display();
-  while (paused)
+#ifndef PAGE_STRIP_RENDER
+  for (byte i = 0; i < phase.play.extraCount; i++)
   {
-    delay(150);
-    //Unpause if FIRE is pressed
-    pad2 = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
-    if (pad2 > 1 && oldpad2 == 0 && released)
-    {
-        arduboy.fillRect(52, 45, 30, 11, 0);
-
-        paused=false;
-    }
-    oldpad2=pad2;
+    drawSpriteShifted(phase.play.extraX[i], phase.play.extraY[i], ballShifted, color);
   }
+#endif
 }
 
-void Score()
+void plotShots(byte color)
 {
-  score += (level*10);
-  sprintf(text, "SCORE:%u", score);
-  arduboy.setCursor(80, 90);
-  arduboy.print(text);
+#ifndef PAGE_STRIP_RENDER
+  for (byte i = 0; i < phase.play.shotCount; i++)
+  {
+    fillRectUnchecked(phase.play.shotX[i], phase.play.shotY[i], 1, SHOT_LENGTH, color);
+  }
+#endif
 }
 
-void newLevel(){
-  //Undraw paddle
-  arduboy.drawRect(xPaddle, 63, 11, 1, 0);
+//Drops are drawn inverted as they fall over bricks, so plotting one
+//twice takes it off again
+void plotDrops()
+{
+#ifndef PAGE_STRIP_RENDER
+  for (byte link = phase.play.dropLive; link; link = phase.play.dropNext[link - 1])
+  {
+    byte type = phase.play.dropType[link - 1];
+    fillRectUnchecked(phase.play.dropX[link - 1], phase.play.dropY[link - 1],
+                      pgm_read_byte(&DROP_WIDTH[type]), pgm_read_byte(&DROP_HEIGHT[type]),
+                      DRAW_INVERT);
+  }
+#endif
+}
 
-  //Undraw ball
-  arduboy.drawPixel(xb,   yb,   0);
-  arduboy.drawPixel(xb+1, yb,   0);
-  arduboy.drawPixel(xb,   yb+1, 0);
-  arduboy.drawPixel(xb+1, yb+1, 0);
+//Explosive bricks are filled, indestructible ones have double sides
+//and tough ones a dot in the middle. Erasing fills, clearing any kind.
+#ifdef SLIDING_ROWS
+//Fills a rect at ring position x, putting what is past the ring's end
+//back at the left and dropping what falls off screen between the two
+void fillRing(byte x, byte y, byte w, byte h, byte color)
+{
+  if (x >= RING_WIDTH)
+  {
+    x -= RING_WIDTH;
+  }
+  if (x + w > RING_WIDTH)
+  {
+    fillRectUnchecked(0, y, x + w - RING_WIDTH, h, color);
+    w = RING_WIDTH - x;
+  }
+  if (x + w > WIDTH)
+  {
+    w = (x < WIDTH) ? WIDTH - x : 0;
+  }
+  if (w)
+  {
+    fillRectUnchecked(x, y, w, h, color);
+  }
+}
 
-  //Alter various variables to reset the game
-  xPaddle = 54;
-  yb = 60;
-  brickCount = 0;
-  released = false;
+//Draws a brick that runs off the right of the screen in two parts
+void plotWrappedBrick(byte row, byte column, byte color)
+{
+  unsigned int bit = 1 << column;
+  byte x = brickX(row, column);
+  byte y = 2+6*row;
 
-  //Draws new bricks and resets their values
-  for (byte row = 0; row < 4; row++) {
-    for (byte column = 0; column < 13; column++)
+  if (color == 0 || (phase.play.explosive[row] & bit))
+  {
+    fillRing(x, y, 8, 4, color);
+    return;
+  }
+  fillRing(x, y, 8, 1, color);
+  fillRing(x, y + 3, 8, 1, color);
+  fillRing(x, y, 1, 4, color);
+  fillRing(x + 7, y, 1, 4, color);
+  if (phase.play.solid[row] & bit)
+  {
+    fillRing(x + 1, y, 1, 4, color);
+    fillRing(x + 6, y, 1, 4, color);
+  }
+  if (phase.play.tough[row] & bit)
+  {
+    fillRing(x + 3, y + 1, 2, 2, color);
+  }
+}
+#endif
+
+void plotBrick(byte row, byte column, byte color)
+{
+#ifndef PAGE_STRIP_RENDER
+  unsigned int bit = 1 << column;
+  byte x = brickX(row, column);
+  byte y = 2+6*row;
+
+#ifdef SLIDING_ROWS
+  if (x > WIDTH - 8)
+  {
+    plotWrappedBrick(row, column, color);
+    return;
+  }
+#endif
+  if (color == 0 || (phase.play.explosive[row] & bit))
+  {
+    fillRectUnchecked(x, y, 8, 4, color);
+    return;
+  }
+  drawRectUnchecked(x, y, 8, 4, color);
+  if (phase.play.solid[row] & bit)
+  {
+    drawRectUnchecked(x + 1, y, 6, 4, color);
+  }
+  if (phase.play.tough[row] & bit)
+  {
+    fillRectUnchecked(x + 3, y + 1, 2, 2, color);
+  }
+#endif
+}
+
+#ifdef PAGE_STRIP_RENDER
+//Draws the brick rows into each page as it is rendered, since the wall
+//would take more display list operations than there is room for
+void gamePage(byte page)
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    unsigned int alive = phase.play.bricks[row];
+    unsigned int explosive = alive & phase.play.explosive[row];
+    stripPageRectRow(0, 2+6*row, 8, 4, 10, alive & ~explosive);
+    if (explosive)
+    {
+      stripPageFillRow(0, 2+6*row, 8, 4, 10, explosive);
+    }
+    if (alive & phase.play.solid[row])
+    {
+      stripPageRectRow(1, 2+6*row, 6, 4, 10, alive & phase.play.solid[row]);
+    }
+    if (alive & phase.play.tough[row])
+    {
+      stripPageFillRow(3, 3+6*row, 2, 2, 10, alive & phase.play.tough[row]);
+    }
+  }
+}
+
+//Records what moves into the display list, gamePage() adds the bricks
+void recordGameFrame(boolean withBall)
+{
+  stripBegin();
+  if (withBall)
+  {
+    stripFill(xb, yb, 2, 2);
+    for (byte i = 0; i < phase.play.extraCount; i++)
+    {
+      stripFill(phase.play.extraX[i], phase.play.extraY[i], 2, 2);
+    }
+  }
+  for (byte i = 0; i < phase.play.shotCount; i++)
+  {
+    stripFill(phase.play.shotX[i], phase.play.shotY[i], 1, SHOT_LENGTH);
+  }
+  for (byte link = phase.play.dropLive; link; link = phase.play.dropNext[link - 1])
+  {
+    byte type = phase.play.dropType[link - 1];
+    stripFill(phase.play.dropX[link - 1], phase.play.dropY[link - 1],
+              pgm_read_byte(&DROP_WIDTH[type]), pgm_read_byte(&DROP_HEIGHT[type]));
+  }
+  stripFill(xPaddle, 63, paddleWidth, 1);
+}
+
+//The balls, shots, drops and paddle, plus GAME OVER or PAUSE on top
+static_assert(STRIP_MAX_OPS >= 1 + EXTRA_BALLS + SHOT_MAX + DROP_POOL + 1 + 2,
+              "display list too short for a gameplay frame");
+#endif
+
+//The HUD sits below the screen, where drawing clips it, so strip frames
+//leave it out
+void drawLives()
+{
+#ifndef PAGE_STRIP_RENDER
+  sprintf_P(text, FMT_LIVES, lives);
+  drawText(0, 90, text);
+#endif
+}
+
+void drawGameOver()
+{
+#ifdef PAGE_STRIP_RENDER
+  recordGameFrame(false);
+  stripTextP(52, 42, STR_GAME);
+  stripTextP(52, 54, STR_OVER);
+  stripRender(0, HEIGHT / 8 - 1, gamePage);
+#else
+  plotBall(0);
+  drawTextP(52, 42, STR_GAME);
+  drawTextP(52, 54, STR_OVER);
+  arduboy.display();
+#endif
+  playScore(gameOverScore);
+}
+
+void pause()
+{
+  paused = true;
+  //Draw pause to the screen
+#ifdef PAGE_STRIP_RENDER
+  recordGameFrame(true);
+  stripTextP(52, 45, STR_PAUSE);
+  stripRender(0, HEIGHT / 8 - 1, gamePage);
+#else
+  drawTextP(52, 45, STR_PAUSE);
+  arduboy.display();
+#endif
+  while (paused)
+  {
+    delay(150);
+    //Unpause if FIRE is pressed
+    pad2 = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
+    if (pad2 > 1 && oldpad2 == 0 && released)
+    {
+#ifndef PAGE_STRIP_RENDER
+        arduboy.fillRect(52, 45, 30, 11, 0);
+#endif
+
+        paused=false;
+    }
+    oldpad2=pad2;
+  }
+  resetPhysicsClock();
+}
+
+void drawScore()
+{
+#ifndef PAGE_STRIP_RENDER
+  sprintf_P(text, FMT_SCORE, score);
+  drawText(80, 90, text);
+#endif
+}
+
+//Breaks the brick at row, column, unless it can't be broken or still
+//has a hit left, in which case the ball just bounces off it
+void hitBrick(byte row, byte column, byte normal)
+{
+  unsigned int bit = 1 << column;
+
+  if (phase.play.solid[row] & bit)
+  {
+    //Always come back out of a brick that can't be broken. Only the
+    //ball can get inside one without bouncing, never a shot
+    if (normal == 0 && !bounced)
+    {
+      dy = -dy;
+      yb += dy;
+      bounced = true;
+    }
+    phase.play.hitSounds |= SOUND_SOLID;
+    return;
+  }
+
+  if (phase.play.tough[row] & bit)
+  {
+    phase.play.tough[row] &= ~bit;
+    queueBrickHit(HIT_TOUGH | (row << 4) | column);
+    phase.play.hitSounds |= SOUND_TOUGH;
+    return;
+  }
+
+  phase.play.bricks[row] &= ~bit;
+  queueBrickHit((row << 4) | column);
+  if (normal == HIT_VERTICAL || normal == HIT_HORIZONTAL)
+  {
+    phase.play.hitSounds |= SOUND_BOUNCE;
+  }
+}
+
+//A ball that bounced off a brick it can't break may have been drawn
+//over it, and erasing the ball takes those pixels too. Puts back any
+//brick still standing under the ball at x, y.
+void repairBricks(int x, int y)
+{
+#ifndef PAGE_STRIP_RENDER
+  if (y + 1 < 2 || y >= BRICKS_BOTTOM)
+  {
+    return;
+  }
+  for (byte row = (y < 2) ? 0 : ((y - 2) * 43) >> 8; row < ROWS && 2 + 6*row <= y + 1; row++)
+  {
+#ifdef SLIDING_ROWS
+    //The ball's two columns of pixels, which may be either side of the wrap
+    byte first = (ringX(row, x) * 205) >> 11;
+    byte second = (ringX(row, x + 1) * 205) >> 11;
+    if (phase.play.bricks[row] & (1 << first))
+    {
+      plotBrick(row, first, 1);
+    }
+    if (second != first && (phase.play.bricks[row] & (1 << second)))
+    {
+      plotBrick(row, second, 1);
+    }
+#else
+    for (byte column = (x * 205) >> 11; column < COLUMNS && 10*column <= x + 1; column++)
+    {
+      if (phase.play.bricks[row] & (1 << column))
+      {
+        plotBrick(row, column, 1);
+      }
+    }
+#endif
+  }
+#endif
+}
+
+//True once every brick that can break is gone. Costs the same however
+//many special bricks the wall has.
+boolean wallCleared()
+{
+  unsigned int left = 0;
+
+  for (byte row = 0; row < ROWS; row++)
+  {
+    left |= phase.play.bricks[row] & ~phase.play.solid[row];
+  }
+  return left == 0;
+}
+
+//Queues a brick hit, applying the queue early if it is already full.
+//An explosive brick also queues its blast.
+void queueBrickHit(byte hit)
+{
+  byte row = (hit >> 4) & 0x07;
+  byte column = hit & 0x0F;
+
+  if (!(hit & HIT_TOUGH) && (phase.play.explosive[row] & (1 << column)) &&
+      phase.play.blastCount < BLAST_QUEUE)
+  {
+    byte tail = (phase.play.blastHead + phase.play.blastCount++) & (BLAST_QUEUE - 1);
+    phase.play.blastQueue[tail] = hit;
+  }
+
+  if (phase.play.hitCount == HIT_QUEUE_SIZE)
+  {
+    applyBrickHits();
+  }
+  phase.play.hitQueue[phase.play.hitCount++] = hit;
+}
+
+//Sets off the oldest queued blasts, each destroying the bricks in the
+//3x3 block around it through the row masks
+void spreadBlasts()
+{
+  for (byte n = 0; n < BLASTS_PER_FRAME && phase.play.blastCount > 0; n++)
+  {
+    byte blast = phase.play.blastQueue[phase.play.blastHead];
+    byte row = blast >> 4;
+    byte column = blast & 0x0F;
+    unsigned int around = ((7 << column) >> 1) & FULL_ROW;
+
+    phase.play.blastHead = (phase.play.blastHead + 1) & (BLAST_QUEUE - 1);
+    phase.play.blastCount--;
+
+    for (byte r = row ? row - 1 : 0; r <= row + 1 && r < ROWS; r++)
+    {
+      unsigned int hit = phase.play.bricks[r] & ~phase.play.solid[r] & around;
+
+      phase.play.bricks[r] &= ~hit;
+      for (byte c = column ? column - 1 : 0; hit; c++)
+      {
+        if (hit & (1 << c))
+        {
+          hit &= ~(1 << c);
+          queueBrickHit((r << 4) | c);
+          phase.play.hitSounds |= SOUND_BLAST;
+        }
+      }
+    }
+  }
+}
+
+//Where the ball met the paddle as an index into PADDLE_SPIN. A wide
+//paddle keeps the spin table's edges at its own edges.
+byte paddleOffset()
+{
+  int offset = xb - xPaddle + 1 - ((paddleWidth - PADDLE_WIDTH) >> 1);
+
+  if (offset < 0)
+  {
+    return 0;
+  }
+  if (offset > PADDLE_WIDTH + 2)
+  {
+    return PADDLE_WIDTH + 2;
+  }
+  return offset;
+}
+
+//Swaps extra ball i with the ball globals, so the extra balls share
+//bounceBall() with the first one
+void swapExtraBall(byte i)
+{
+  int x = xb;
+  int y = yb;
+  int ddx = dx;
+  int ddy = dy;
+
+  xb = phase.play.extraX[i];
+  yb = phase.play.extraY[i];
+  dx = phase.play.extraDx[i];
+  dy = phase.play.extraDy[i];
+  phase.play.extraX[i] = x;
+  phase.play.extraY[i] = y;
+  phase.play.extraDx[i] = ddx;
+  phase.play.extraDy[i] = ddy;
+}
+
+void moveExtraBalls()
+{
+  byte i = 0;
+
+  while (i < phase.play.extraCount)
+  {
+    boolean inPlay;
+
+    swapExtraBall(i);
+    inPlay = bounceBall();
+    swapExtraBall(i);
+    if (inPlay)
+    {
+      i++;
+    }
+    else
+    {
+      //Last one fills the gap
+      phase.play.extraCount--;
+      phase.play.extraX[i] = phase.play.extraX[phase.play.extraCount];
+      phase.play.extraY[i] = phase.play.extraY[phase.play.extraCount];
+      phase.play.extraDx[i] = phase.play.extraDx[phase.play.extraCount];
+      phase.play.extraDy[i] = phase.play.extraDy[phase.play.extraCount];
+    }
+  }
+}
+
+//Takes a slot from the pool and starts a power-up falling from it,
+//unless every slot is already falling
+void spawnDrop(byte type, byte x, byte y)
+{
+  byte slot;
+
+  if (phase.play.dropFree)
+  {
+    slot = phase.play.dropFree - 1;
+    phase.play.dropFree = phase.play.dropNext[slot];
+  }
+  else if (phase.play.dropUsed < DROP_POOL)
+  {
+    slot = phase.play.dropUsed++;
+  }
+  else
+  {
+    return;
+  }
+
+  phase.play.dropX[slot] = x;
+  phase.play.dropY[slot] = y;
+  phase.play.dropType[slot] = type;
+  phase.play.dropNext[slot] = phase.play.dropLive;
+  phase.play.dropLive = slot + 1;
+}
+
+//Drops fall a pixel every other step. At the paddle row they either
+//land on the paddle and take effect or are gone, and their slot is freed
+void moveDrops()
+{
+  byte *link = &phase.play.dropLive;
+
+  if (phase.play.dropTick++ & 1)
+  {
+    return;
+  }
+
+  while (*link)
+  {
+    byte slot = *link - 1;
+    byte type = phase.play.dropType[slot];
+    byte x = phase.play.dropX[slot];
+    byte y = ++phase.play.dropY[slot];
+
+    if (y + pgm_read_byte(&DROP_HEIGHT[type]) < 63)
+    {
+      link = &phase.play.dropNext[slot];
+      continue;
+    }
+
+    if (x + pgm_read_byte(&DROP_WIDTH[type]) > xPaddle && x < xPaddle + paddleWidth)
+    {
+      applyPowerUp(type);
+    }
+    *link = phase.play.dropNext[slot];
+    phase.play.dropNext[slot] = phase.play.dropFree;
+    phase.play.dropFree = slot + 1;
+  }
+}
+
+void applyPowerUp(byte type)
+{
+  playTone(TONE_1318, 250);
+  if (type == DROP_WIDE)
+  {
+    plotPaddle(0);
+    paddleWidth = WIDE_PADDLE;
+    //Kept even, as the paddle moves two pixels at a time
+    if (xPaddle > WIDTH - paddleWidth)
+    {
+      xPaddle = (WIDTH - paddleWidth) & ~1;
+    }
+    plotPaddle(1);
+  }
+  else if (type == DROP_SLOW)
+  {
+    phase.play.slowSteps = SLOW_STEPS;
+  }
+  else if (type == DROP_LASER)
+  {
+    phase.play.laserPairs = LASER_PAIRS;
+  }
+  else if (released)
+  {
+    //Split more balls off the first, heading out at other angles
+    while (phase.play.extraCount < EXTRA_BALLS)
+    {
+      byte i = phase.play.extraCount++;
+      phase.play.extraX[i] = xb;
+      phase.play.extraY[i] = yb;
+      phase.play.extraDy[i] = dy;
+      if (i == 0)
+      {
+        phase.play.extraDx[i] = -dx;
+      }
+      else
+      {
+        phase.play.extraDx[i] = (abs(dx) == 2) ? dx / 2 : dx * 2;
+      }
+    }
+  }
+}
+
+//Starts a shot climbing from x, noting the brick column it will meet
+void addShot(byte x)
+{
+  byte i = phase.play.shotCount++;
+
+  phase.play.shotX[i] = x;
+  phase.play.shotY[i] = 63 - SHOT_LENGTH;
+  phase.play.shotColumn[i] = columnAt(0, x);
+}
+
+//Fires a shot up from each end of the paddle when FIRE goes down while
+//the laser is on
+void fireLaser()
+{
+  boolean held = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
+
+  if (held && !phase.play.laserHeld && released &&
+      phase.play.laserPairs > 0 && phase.play.shotCount + 2 <= SHOT_MAX)
+  {
+    addShot(xPaddle + 1);
+    addShot(xPaddle + paddleWidth - 2);
+    phase.play.laserPairs--;
+    playTone(TONE_987, 100);
+  }
+  phase.play.laserHeld = held;
+}
+
+//Shots climb SHOT_SPEED pixels a step. A shot never changes column, so
+//finding a brick is one bit test on the row mask its tip has reached.
+//Sliding rows move under it, so there the column comes from the row.
+void moveShots()
+{
+  byte i = 0;
+
+  while (i < phase.play.shotCount)
+  {
+    byte y = phase.play.shotY[i] - SHOT_SPEED;
+    byte column = phase.play.shotColumn[i];
+    boolean spent = y < 2;
+
+    if (!spent && y < BRICKS_BOTTOM)
+    {
+      //(y - 2) / 6 by multiply and shift, exact over the wall
+      byte row = ((y - 2) * 43) >> 8;
+      boolean inside = (y - 2) - 6*row < 4;
+#ifdef SLIDING_ROWS
+      //The row may have slid under the shot since it was fired. With the
+      //tip in the gap, a brick can have slid in across the tail below.
+      if (!inside && row < ROWS - 1)
+      {
+        row++;
+        inside = true;
+      }
+      column = columnAt(row, phase.play.shotX[i]);
+#endif
+      if (column != NO_BRICK && inside &&
+          (phase.play.bricks[row] & (1 << column)))
+      {
+        hitBrick(row, column, HIT_SHOT);
+        spent = true;
+      }
+    }
+
+    if (spent)
+    {
+      //Last one fills the gap
+      phase.play.shotCount--;
+      phase.play.shotX[i] = phase.play.shotX[phase.play.shotCount];
+      phase.play.shotY[i] = phase.play.shotY[phase.play.shotCount];
+      phase.play.shotColumn[i] = phase.play.shotColumn[phase.play.shotCount];
+    }
+    else
+    {
+      phase.play.shotY[i] = y;
+      i++;
+    }
+  }
+}
+
+//Takes every falling power-up and extra ball off the screen and out of play
+void clearPowerUps()
+{
+  plotDrops();
+  plotShots(0);
+  plotExtraBalls(0);
+  resetPowerUps();
+}
+
+//Takes them out of play once they are already off the screen
+void resetPowerUps()
+{
+  phase.play.dropLive = 0;
+  phase.play.dropFree = 0;
+  phase.play.dropUsed = 0;
+  phase.play.extraCount = 0;
+  phase.play.slowSteps = 0;
+  phase.play.shotCount = 0;
+  phase.play.laserPairs = 0;
+}
+
+//Scores, erases and sounds every brick hit queued by moveBall() this
+//frame. Tough bricks that took a hit are redrawn with one less.
+void applyBrickHits()
+{
+  byte broken = 0;
+
+  for (byte i = 0; i < phase.play.hitCount; i++)
+  {
+    byte row = (phase.play.hitQueue[i] >> 4) & 0x07;
+    byte column = phase.play.hitQueue[i] & 0x0F;
+    plotBrick(row, column, 0);
+    if (phase.play.hitQueue[i] & HIT_TOUGH)
+    {
+      plotBrick(row, column, 1);
+      continue;
+    }
+    broken++;
+
+    if (++phase.play.bricksToDrop == DROP_EVERY)
+    {
+      byte type = phase.play.nextDrop;
+      int centre = brickX(row, column) + 4;
+#ifdef SLIDING_ROWS
+      //A brick wrapped round the edge drops from its far side
+      if (centre >= RING_WIDTH)
+      {
+        centre -= RING_WIDTH;
+      }
+#endif
+      byte width = pgm_read_byte(&DROP_WIDTH[type]);
+      spawnDrop(type, constrain(centre - (width >> 1), 0, WIDTH - width), 6 + 6*row);
+      phase.play.bricksToDrop = 0;
+      phase.play.nextDrop = (type + 1 == DROP_TYPES) ? 0 : type + 1;
+    }
+  }
+
+  if (broken)
+  {
+    score += (level*10) * broken;
+    phase.play.hudDirty |= HUD_SCORE;
+  }
+  if (phase.play.hitSounds & SOUND_BLAST)
+  {
+    playTone(TONE_175, 120);
+  }
+  else if (phase.play.hitSounds & SOUND_BOUNCE)
+  {
+    playTone(TONE_261, 250);
+  }
+  else if (phase.play.hitSounds & SOUND_TOUGH)
+  {
+    playTone(TONE_784, 100);
+  }
+  else if (phase.play.hitSounds & SOUND_SOLID)
+  {
+    playTone(TONE_1318, 100);
+  }
+  phase.play.hitCount = 0;
+  phase.play.hitSounds = 0;
+}
+
+void newLevel(){
+  //Undraw paddle
+  plotPaddle(0);
+
+  //Undraw ball
+  plotBall(0);
+  clearPowerUps();
+
+  //Alter various variables to reset the game
+  xPaddle = 54;
+  paddleWidth = PADDLE_WIDTH;
+  yb = 60;
+  released = false;
+
+  //Draws new bricks and resets their values
+#ifndef PAGE_STRIP_RENDER
+  fillRectUnchecked(0, 2, WIDTH, 6 * ROWS, 0);
+#endif
+  phase.play.blastCount = 0;
+#ifdef DESCENDING_WALL
+  phase.play.descendSteps = DESCEND_STEPS;
+#endif
+#ifdef SLIDING_ROWS
+  phase.play.slideSteps = 0;
+#endif
+  for (byte row = 0; row < ROWS; row++) {
+    boolean dealt = row < START_ROWS;
+#ifdef SLIDING_ROWS
+    phase.play.rowX[row] = 0;
+    phase.play.rowSlide[row] = dealt ? (signed char)pgm_read_byte(&SLIDE[row]) : 0;
+#endif
+    phase.play.bricks[row] = dealt ? FULL_ROW : 0;
+    phase.play.explosive[row] = dealt ? pgm_read_word(&EXPLOSIVE[row]) : 0;
+    phase.play.solid[row] = dealt ? pgm_read_word(&SOLID[row]) : 0;
+    phase.play.tough[row] = dealt ? pgm_read_word(&TOUGH[row]) : 0;
+    for (byte column = 0; dealt && column < 13; column++)
+    {
+      plotBrick(row, column, 1);
+    }
+  }
+
+  //Draws the initial lives
+  drawLives();
+  resetPhysicsClock();
+
+  //Draws the initial score
+  drawScore();
+}
+
+//Returns how many fixed physics steps the time since the last frame
+//covers, so ball and paddle speed don't depend on the frame rate
+byte physicsSteps()
+{
+  unsigned long now = millis();
+  unsigned long elapsed = now - physicsTime;
+  byte steps = 0;
+
+  physicsTime = now;
+  if (elapsed > MAX_ELAPSED)
+  {
+    elapsed = MAX_ELAPSED;
+  }
+  physicsAccum += (unsigned int)elapsed * PHYSICS_RATE;
+
+  while (physicsAccum >= PHYSICS_STEP && steps < MAX_CATCHUP)
+  {
+    physicsAccum -= PHYSICS_STEP;
+    steps++;
+  }
+
+  //Drop time we can't catch up on rather than falling further behind
+  if (physicsAccum >= PHYSICS_STEP)
+  {
+    physicsAccum = 0;
+  }
+  return steps;
+}
+
+//Switches phase, clearing the state the previous phase left behind
+void enterPhase(byte newPhase)
+{
+  memset(&phase, 0, sizeof(phase));
+  gamePhase = newPhase;
+}
+
+//Restarts the physics clock after time that shouldn't move the ball
+void resetPhysicsClock()
+{
+  physicsTime = millis();
+  physicsAccum = 0;
+}
+
+void setFrameTier(byte tier)
+{
+  frameTier = tier;
+  arduboy.setFrameRate(pgm_read_byte(&FRAME_TIERS[tier]));
+  highLoadFrames = 0;
+  lowLoadFrames = 0;
+}
+
+//Steps the frame rate down a tier when frames keep overrunning and
+//back up once there has been headroom for a while
+void adaptFrameRate()
+{
+  int load = arduboy.cpuLoad();
+
+  if (load > LOAD_HIGH)
+  {
+    lowLoadFrames = 0;
+    if (++highLoadFrames >= FRAMES_HIGH && frameTier > 0)
+    {
+      setFrameTier(frameTier - 1);
+    }
+  }
+  else if (load < LOAD_LOW)
+  {
+    highLoadFrames = 0;
+    if (++lowLoadFrames >= FRAMES_LOW && frameTier < TIER_COUNT - 1)
     {
-      isHit[row][column] = false;
-      arduboy.drawRect(10*column, 2+6*row, 8, 4, 1);
+      setFrameTier(frameTier + 1);
     }
   }
-
-  //Draws the initial lives
-  drawLives();
-
-  //Draws the initial score
-  sprintf(text, "SCORE:%u", score);
-  arduboy.setCursor(80, 90);
-  arduboy.print(text);
+  else
+  {
+    highLoadFrames = 0;
+    lowLoadFrames = 0;
+  }
 }
 
-//Used to delay images while reading button input
-boolean pollFireButton(int n)
+//Reads FIRE, true only on the frame it goes down
+boolean firePressed()
 {
-  for(int i = 0; i < n; i++)
+  pad = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
+  if(pad == 1 && oldpad == 0)
   {
-    delay(15);
-    pad = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
-    if(pad == 1 && oldpad == 0)
-    {
-      oldpad3 = 1; //Forces pad loop 3 to run once
-      return true;
-    }
-    oldpad = pad;
+    oldpad3 = 1; //Forces pad loop 3 to run once
+    return true;
   }
+  oldpad = pad;
   return false;
 }
 
-//Function by nootropic design to display highscores
-boolean displayHighScores(byte file)
+//Waits like SCRIPT_WAIT_MS, but pressing FIRE ends the script and
+//starts the game
+#define WAIT_OR_FIRE(s, ms) \
+  do { (s)->timer = millis(); \
+    SCRIPT_WAIT_UNTIL(s, (start = firePressed()) || SCRIPT_ELAPSED(s) >= (ms)); \
+    if (start) SCRIPT_EXIT(s); } while (0)
+
+//Reads a high score table into the title phase's cache
+void loadHighScores(byte file)
 {
-  byte y = 10;
-  byte x = 24;
   // Each block of EEPROM has 10 high scores, and each high score entry
   // is 5 bytes long:  3 bytes for initials and two bytes for score.
   int address = file*10*5;
   byte hi, lo;
-  arduboy.clear();
-  arduboy.setCursor(32, 0);
-  arduboy.print("HIGH SCORES");
-  arduboy.display();
 
   for(int i = 0; i < 10; i++)
   {
-    sprintf(text, "%2d", i+1);
-    arduboy.setCursor(x,y+(i*8));
-    arduboy.print( text);
-    arduboy.display();
     hi = EEPROM.read(address + (5*i));
     lo = EEPROM.read(address + (5*i) + 1);
 
     if ((hi == 0xFF) && (lo == 0xFF))
     {
-      score = 0;
+      phase.title.scores[i] = 0;
     }
     else
     {
-      score = (hi << 8) | lo;
+      phase.title.scores[i] = (hi << 8) | lo;
     }
 
-    initials[0] = (char)EEPROM.read(address + (5*i) + 2);
-    initials[1] = (char)EEPROM.read(address + (5*i) + 3);
-    initials[2] = (char)EEPROM.read(address + (5*i) + 4);
+    phase.title.initials[i][0] = (char)EEPROM.read(address + (5*i) + 2);
+    phase.title.initials[i][1] = (char)EEPROM.read(address + (5*i) + 3);
+    phase.title.initials[i][2] = (char)EEPROM.read(address + (5*i) + 4);
+  }
+  phase.title.loaded = true;
+}
 
-    if (score > 0)
-    {
-      sprintf(text, "%c%c%c %u", initials[0], initials[1], initials[2], score);
-      arduboy.setCursor(x + 24, y + (i*8));
-      arduboy.print(text);
-      arduboy.display();
-    }
+#ifdef PAGE_STRIP_RENDER
+//Draws the table row on each page under the heading as it is rendered
+void scoresPage(byte page)
+{
+  byte i = page - 1;
+
+  if (page == 0)
+  {
+    return;
   }
-  if (pollFireButton(300))
+  sprintf_P(text, FMT_RANK, i+1);
+  stripPageText(24, page*8, text);
+
+  if (phase.title.scores[i] > 0)
   {
-    return true;
+    sprintf_P(text, FMT_ENTRY, phase.title.initials[i][0], phase.title.initials[i][1], phase.title.initials[i][2], phase.title.scores[i]);
+    stripPageText(48, page*8, text);
   }
-  return false;
-  arduboy.display();
 }
 
-boolean titleScreen()
+//Function by nootropic design to display highscores
+//Records the heading, scoresPage() adds the rows as they are rendered
+void drawHighScores(byte file)
 {
-  //Clears the screen
-  arduboy.clear();
-  arduboy.setCursor(16,22);
-  arduboy.setTextSize(2);
-  arduboy.print("ARAKNOID");
-  arduboy.setTextSize(1);
-  arduboy.display();
-  if (pollFireButton(25))
+  if (!phase.title.loaded)
   {
-    return true;
+    loadHighScores(file);
+  }
+
+  stripBegin();
+  stripTextP(32, 0, STR_HIGH_SCORES);
+}
+
+//Sends the "PRESS FIRE!" band, the only part of the title that changes
+void displayPressFire(boolean shown)
+{
+  stripBegin();
+  if (shown)
+  {
+    stripTextP(31, 53, STR_PRESS_FIRE);
   }
+  stripRender(53 >> 3, (53 + 7) >> 3, 0);
+}
+#else
+//Function by nootropic design to display highscores
+//Draws the whole table into the framebuffer, to be shown in one push
+void drawHighScores(byte file)
+{
+  //Rows start on a page under the heading, so every glyph is a byte copy
+  byte y = 8;
+  byte x = 24;
 
-  //Flash "Press FIRE" 5 times
-  for(byte i = 0; i < 5; i++)
+  if (!phase.title.loaded)
   {
-    //Draws "Press FIRE"
-    //arduboy.bitmap(31, 53, fire);  arduboy.display();
-    arduboy.setCursor(31, 53);
-    arduboy.print("PRESS FIRE!");
-    arduboy.display();
+    loadHighScores(file);
+  }
+
+  arduboy.clear();
+  drawTextP(32, 0, STR_HIGH_SCORES);
+  for(int i = 0; i < 10; i++)
+  {
+    sprintf_P(text, FMT_RANK, i+1);
+    drawText(x, y+(i*8), text);
 
-    if (pollFireButton(50))
+    if (phase.title.scores[i] > 0)
     {
-      return true;
+      sprintf_P(text, FMT_ENTRY, phase.title.initials[i][0], phase.title.initials[i][1], phase.title.initials[i][2], phase.title.scores[i]);
+      drawText(x + 24, y + (i*8), text);
     }
-    //Removes "Press FIRE"
+  }
+}
+
+//Pushes the "PRESS FIRE!" band, the only part of the title that changes
+void displayPressFire(boolean shown)
+{
+  if (shown)
+  {
+    drawTextP(31, 53, STR_PRESS_FIRE);
+  }
+  else
+  {
+    fillRectUnchecked(31, 53, 11*6, 8, 0);
+  }
+  displayRegion(31, 31 + 11*6 - 1, 53 >> 3, (53 + 7) >> 3);
+}
+#endif
+
+//Title screen and high scores, switched between until FIRE is pressed
+byte titleSequence(Script *s)
+{
+  SCRIPT_BEGIN(s);
+  enterPhase(PHASE_TITLE);
+  while (true)
+  {
+    //Draws the title once, only the "PRESS FIRE!" band changes after this
+#ifdef PAGE_STRIP_RENDER
+    stripBegin();
+    stripText2xP(16, 22, STR_TITLE);
+    stripRender(0, HEIGHT / 8 - 1, 0);
+#else
     arduboy.clear();
-    arduboy.setCursor(16,22);
-    arduboy.setTextSize(2);
-    arduboy.print("ARAKNOID");
-    arduboy.setTextSize(1);
+    drawText2xP(16, 22, STR_TITLE);
     arduboy.display();
+#endif
+    WAIT_OR_FIRE(s, 375);
 
-    arduboy.display();
-    if (pollFireButton(25))
+    //Flash "Press FIRE" 5 times
+    for(s->count = 0; s->count < 5; s->count++)
+    {
+      //Draws "Press FIRE"
+      displayPressFire(true);
+      WAIT_OR_FIRE(s, 750);
+
+      //Removes "Press FIRE"
+      displayPressFire(false);
+      WAIT_OR_FIRE(s, 375);
+    }
+
+    drawHighScores(2);
+#ifdef HIGH_SCORE_REVEAL
+    //Wipes the table on a page at a time
+    for (s->count = 0; s->count < HEIGHT / 8; s->count++)
     {
-      return true;
+#ifdef PAGE_STRIP_RENDER
+      stripRender(s->count, s->count, scoresPage);
+#else
+      displayRegion(0, WIDTH - 1, s->count, s->count);
+#endif
+      WAIT_OR_FIRE(s, 60);
     }
+#elif defined(PAGE_STRIP_RENDER)
+    stripRender(0, HEIGHT / 8 - 1, scoresPage);
+#else
+    arduboy.display();
+#endif
+    WAIT_OR_FIRE(s, 4500);
   }
+  SCRIPT_END(s);
+}
 
-  return false;
+const byte ENTRY_FRAME_RATE = 30; //Frames per second while entering initials
+const byte ENTRY_REPEAT = LEFT_BUTTON | RIGHT_BUTTON | UP_BUTTON | DOWN_BUTTON | B_BUTTON; //Buttons that repeat when held
+const byte REPEAT_DELAY = 12;     //Frames a button is held before it repeats
+const byte REPEAT_RATE = 5;       //Frames between repeats
+
+//Reads every button into one mask so presses can be edge detected
+byte readButtons()
+{
+  byte buttons = 0;
+  if (arduboy.pressed(LEFT_BUTTON)) buttons |= LEFT_BUTTON;
+  if (arduboy.pressed(RIGHT_BUTTON)) buttons |= RIGHT_BUTTON;
+  if (arduboy.pressed(UP_BUTTON)) buttons |= UP_BUTTON;
+  if (arduboy.pressed(DOWN_BUTTON)) buttons |= DOWN_BUTTON;
+  if (arduboy.pressed(A_BUTTON)) buttons |= A_BUTTON;
+  if (arduboy.pressed(B_BUTTON)) buttons |= B_BUTTON;
+  return buttons;
+}
+
+#ifdef PAGE_STRIP_RENDER
+//Records the entry screen: heading, score, the initials with their
+//underlines and the cursor line under the one being edited
+void recordInitials()
+{
+  stripBegin();
+  stripTextP(16, 0, STR_HIGH_SCORE);
+  sprintf_P(text, FMT_NUMBER, score);
+  stripText(88, 0, text);
+  for (byte i = 0; i < 3; i++)
+  {
+    stripGlyph(56 + (i*8), 20, phase.entry.initials[i]);
+    stripFill(56 + (i*8), 27, 7, 1);
+  }
+  stripFill(56 + (phase.entry.index*8), 28, 7, 1);
+}
+#else
+//Draws one initial with its underline
+void drawInitial(byte i)
+{
+  drawGlyph(56 + (i*8), 20, phase.entry.initials[i]);
+  drawHLineUnchecked(56 + (i*8), 27, 7, 1);
+}
+
+//Moves the cursor line under the initial being edited
+void drawInitialsCursor()
+{
+  drawHLineUnchecked(56, 28, 33, 0);
+  drawHLineUnchecked(56 + (phase.entry.index*8), 28, 7, 1);
+}
+#endif
+
+//Returns the buttons that should act this frame: new presses straight
+//away, and held buttons once they have been down long enough to repeat
+byte entryButtons()
+{
+  byte buttons = readButtons();
+  byte pressed = buttons & ~phase.entry.held;
+
+  if (pressed)
+  {
+    phase.entry.repeatFrames = REPEAT_DELAY;
+  }
+  else if ((buttons & ENTRY_REPEAT) && --phase.entry.repeatFrames == 0)
+  {
+    pressed = buttons & ENTRY_REPEAT;
+    phase.entry.repeatFrames = REPEAT_RATE;
+  }
+  phase.entry.held = buttons;
+  return pressed;
 }
 
 //Function by nootropic design to add high scores
+//Only the initial or cursor that changed is redrawn and pushed, and the
+//frame clock paces input so the CPU idles between frames
 void enterInitials()
 {
-  char index = 0;
-
+  char index;
+  byte edited;
+  char *initial;
+  byte buttons;
+
+  enterPhase(PHASE_INITIALS);
+  arduboy.setFrameRate(ENTRY_FRAME_RATE);
+
+  phase.entry.initials[0] = ' ';
+  phase.entry.initials[1] = ' ';
+  phase.entry.initials[2] = ' ';
+  phase.entry.held = readButtons();
+
+#ifdef PAGE_STRIP_RENDER
+  recordInitials();
+  stripRender(0, HEIGHT / 8 - 1, 0);
+#else
   arduboy.clear();
-
-  initials[0] = ' ';
-  initials[1] = ' ';
-  initials[2] = ' ';
+  drawTextP(16, 0, STR_HIGH_SCORE);
+  sprintf_P(text, FMT_NUMBER, score);
+  drawText(88, 0, text);
+  for(byte i = 0; i < 3; i++)
+  {
+    drawInitial(i);
+  }
+  drawInitialsCursor();
+  arduboy.display();
+#endif
 
   while (true)
   {
-    arduboy.display();
-    arduboy.clear();
+    if (!arduboy.nextFrame())
+    {
+      continue;
+    }
 
-    arduboy.setCursor(16,0);
-    arduboy.print("HIGH SCORE");
-    sprintf(text, "%u", score);
-    arduboy.setCursor(88, 0);
-    arduboy.print(text);
-    arduboy.setCursor(56, 20);
-    arduboy.print(initials[0]);
-    arduboy.setCursor(64, 20);
-    arduboy.print(initials[1]);
-    arduboy.setCursor(72, 20);
-    arduboy.print(initials[2]);
-    for(byte i = 0; i < 3; i++)
-    {
-      arduboy.drawLine(56 + (i*8), 27, 56 + (i*8) + 6, 27, 1);
-    }
-    arduboy.drawLine(56, 28, 88, 28, 0);
-    arduboy.drawLine(56 + (index*8), 28, 56 + (index*8) + 6, 28, 1);
-    delay(150);
+    buttons = entryButtons();
+    if (buttons == 0)
+    {
+      continue;
+    }
+
+    index = phase.entry.index;
 
-    if (arduboy.pressed(LEFT_BUTTON) || arduboy.pressed(B_BUTTON))
+    if (buttons & (LEFT_BUTTON | B_BUTTON))
     {
       index--;
       if (index < 0)
@@ -515,73 +2082,96 @@ void enterInitials()
         index = 0;
       } else
       {
-        arduboy.tunes.tone(1046, 250);
+        playTone(TONE_1046, 250);
       }
     }
 
-    if (arduboy.pressed(RIGHT_BUTTON))
+    if (buttons & RIGHT_BUTTON)
     {
       index++;
       if (index > 2)
       {
         index = 2;
       }  else {
-        arduboy.tunes.tone(1046, 250);
+        playTone(TONE_1046, 250);
       }
     }
 
-    if (arduboy.pressed(DOWN_BUTTON))
+    edited = index;
+    initial = &phase.entry.initials[edited];
+
+    if (buttons & DOWN_BUTTON)
     {
-      initials[index]++;
-      arduboy.tunes.tone(523, 250);
+      (*initial)++;
+      playTone(TONE_523, 250);
       // A-Z 0-9 :-? !-/ ' '
-      if (initials[index] == '0')
+      if (*initial == '0')
       {
-        initials[index] = ' ';
+        *initial = ' ';
       }
-      if (initials[index] == '!')
+      if (*initial == '!')
       {
-        initials[index] = 'A';
+        *initial = 'A';
       }
-      if (initials[index] == '[')
+      if (*initial == '[')
       {
-        initials[index] = '0';
+        *initial = '0';
       }
-      if (initials[index] == '@')
+      if (*initial == '@')
       {
-        initials[index] = '!';
+        *initial = '!';
       }
     }
 
-    if (arduboy.pressed(UP_BUTTON))
+    if (buttons & UP_BUTTON)
     {
-      initials[index]--;
-      arduboy.tunes.tone(523, 250);
-      if (initials[index] == ' ') {
-        initials[index] = '?';
+      (*initial)--;
+      playTone(TONE_523, 250);
+      if (*initial == ' ') {
+        *initial = '?';
       }
-      if (initials[index] == '/') {
-        initials[index] = 'Z';
+      if (*initial == '/') {
+        *initial = 'Z';
       }
-      if (initials[index] == 31) {
-        initials[index] = '/';
+      if (*initial == 31) {
+        *initial = '/';
       }
-      if (initials[index] == '@') {
-        initials[index] = ' ';
+      if (*initial == '@') {
+        *initial = ' ';
       }
     }
 
-    if (arduboy.pressed(A_BUTTON))
+    if (buttons & A_BUTTON)
     {
       if (index < 2)
       {
         index++;
-        arduboy.tunes.tone(1046, 250);
+        playTone(TONE_1046, 250);
       } else {
-        arduboy.tunes.tone(1046, 250);
+        playTone(TONE_1046, 250);
+        setFrameTier(frameTier);
         return;
       }
     }
+
+#ifdef PAGE_STRIP_RENDER
+    phase.entry.index = index;
+    recordInitials();
+    //Initials and cursor share one band two pages tall
+    stripRender(20 >> 3, 28 >> 3, 0);
+#else
+    if (buttons & (UP_BUTTON | DOWN_BUTTON))
+    {
+      drawInitial(edited);
+    }
+    if (index != phase.entry.index)
+    {
+      phase.entry.index = index;
+      drawInitialsCursor();
+    }
+    //Initials and cursor share one 33 column band two pages tall
+    displayRegion(56, 88, 20 >> 3, 28 >> 3);
+#endif
   }
 
 }
@@ -633,36 +2223,433 @@ void enterHighScore(byte file)
         // write score and initials to current slot
         EEPROM.write(address + (5*j), ((score >> 8) & 0xFF));
         EEPROM.write(address + (5*j) + 1, (score & 0xFF));
-        EEPROM.write(address + (5*j) + 2, initials[0]);
-        EEPROM.write(address + (5*j) + 3, initials[1]);
-        EEPROM.write(address + (5*j) + 4, initials[2]);
+        EEPROM.write(address + (5*j) + 2, phase.entry.initials[0]);
+        EEPROM.write(address + (5*j) + 3, phase.entry.initials[1]);
+        EEPROM.write(address + (5*j) + 4, phase.entry.initials[2]);
 
         // tmpScore and tmpInitials now hold what we want to
         //write in the next slot.
         score = tmpScore;
-        initials[0] = tmpInitials[0];
-        initials[1] = tmpInitials[1];
-        initials[2] = tmpInitials[2];
+        phase.entry.initials[0] = tmpInitials[0];
+        phase.entry.initials[1] = tmpInitials[1];
+        phase.entry.initials[2] = tmpInitials[2];
       }
 
       score = 0;
-      initials[0] = ' ';
-      initials[1] = ' ';
-      initials[2] = ' ';
+      phase.entry.initials[0] = ' ';
+      phase.entry.initials[1] = ' ';
+      phase.entry.initials[2] = ' ';
 
       return;
     }
   }
 }
 
+#ifdef BENCHMARK
+//Cycle counts come from Timer1 at the CPU clock. Sound is on Timer4, so
+//the sketch leaves Timer1 as the core set it up, for PWM on the LED
+//pins, and each case puts its settings back. The count wraps after
+//65536 cycles (about 4ms), so longer cases are timed by benchMicros().
+//Whether the frame's work is free of software divides is checked on
+//the linked sketch instead, everything the physics task calls included:
+//  make -C host divides ELF=ArduBreakout.ino.elf
+const byte BENCH_RUNS = 64;          //Runs averaged per case, a power of two
+const byte CYCLES_PER_US = F_CPU / 1000000L;
+unsigned int benchOverhead;          //Cycles the timing itself takes
+unsigned int frameBudget;            //us a frame at START_TIER has past the render
+volatile byte benchOffset;           //Keeps paddleSpin() from folding away
+
+//Average cycles fn takes per call
+unsigned int benchCycles(void (*fn)())
+{
+  unsigned long total = 0;
+  byte oldTCCR1A = TCCR1A;
+  byte oldTCCR1B = TCCR1B;
+
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  for (byte i = 0; i < BENCH_RUNS; i++)
+  {
+    unsigned int start, end;
+    noInterrupts();
+    start = TCNT1;
+    fn();
+    end = TCNT1;
+    interrupts();
+    total += end - start;
+  }
+  TCCR1A = oldTCCR1A;
+  TCCR1B = oldTCCR1B;
+  return total / BENCH_RUNS - benchOverhead;
+}
+
+//Average microseconds fn takes per call, for cases too long for Timer1
+unsigned long benchMicros(void (*fn)())
+{
+  unsigned long start = micros();
+  for (byte i = 0; i < BENCH_RUNS; i++)
+  {
+    fn();
+  }
+  return (micros() - start) / BENCH_RUNS;
+}
+
+byte benchRow;                       //Screen page the next line goes on
+
+//Blanks the screen for a page of results
+void benchClear()
+{
+#ifdef PAGE_STRIP_RENDER
+  stripBegin();
+  stripRender(0, HEIGHT / 8 - 1, 0);
+#else
+  arduboy.clear();
+#endif
+  benchRow = 0;
+}
+
+//Shows a line of results on the next page down. Lines are formatted
+//here rather than printed, so strip builds link no Print or its font.
+void benchLine(const char *line)
+{
+#ifdef PAGE_STRIP_RENDER
+  stripBegin();
+  stripText(0, benchRow*8, line);
+  stripRender(benchRow, benchRow, 0);
+#else
+  drawText(0, benchRow*8, line);
+  displayRegion(0, WIDTH - 1, benchRow, benchRow);
+#endif
+  benchRow++;
+}
+
+//Shows a result in us, flagged if runs of it would overrun the frame
+//budget. Work done every physics step pays for MAX_CATCHUP runs, the
+//most one frame can make.
+void benchReport(PGM_P name, unsigned int cycles, byte runs)
+{
+  unsigned long us = (unsigned long)cycles * runs / CYCLES_PER_US;
+  char line[22];
+
+  strcpy_P(line, name);
+  sprintf_P(line + strlen(line), us < frameBudget ? PSTR("%luus OK") : PSTR("%luus SLOW"), us);
+  benchLine(line);
+}
+
+void benchNothing()
+{
+}
+
+void benchStepBall()
+{
+  tick++;
+  stepBall();
+}
+
+void benchPaddleSpin()
+{
+  dx = paddleSpin(benchOffset);
+}
+
+//Ball at 1.5 speed stepping up into a full wall, where it straddles
+//the second and third rows: both are scanned brick by brick and it hits
+//bricks in each. The wall and queue are rebuilt every run, which the
+//timing includes.
+void benchMoveBall()
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    phase.play.bricks[row] = FULL_ROW;
+  }
+  phase.play.hitCount = 0;
+  bounced = false;
+  xb = 60;
+  yb = 13;
+  dx = 2;
+  dy = -1;
+  moveBall();
+}
+
+//Every power-up slot falling and both extra balls in play, the most
+//work the pool can add to a physics step
+void benchPowerUps()
+{
+  phase.play.dropLive = 0;
+  phase.play.dropFree = 0;
+  phase.play.dropUsed = 0;
+  phase.play.dropTick = 0;
+  for (byte i = 0; i < DROP_POOL; i++)
+  {
+    spawnDrop(i % DROP_TYPES, 20 + 20*i, 30);
+  }
+  phase.play.extraCount = EXTRA_BALLS;
+  for (byte i = 0; i < EXTRA_BALLS; i++)
+  {
+    phase.play.extraX[i] = 40 + 20*i;
+    phase.play.extraY[i] = 40;
+    phase.play.extraDx[i] = 2;
+    phase.play.extraDy[i] = -1;
+  }
+  moveExtraBalls();
+  moveDrops();
+}
+
+//SHOT_MAX shots each reaching a brick, the most the laser can add to a step
+void benchShots()
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    phase.play.bricks[row] = FULL_ROW;
+  }
+  phase.play.hitCount = 0;
+  phase.play.shotCount = 0;
+  for (byte i = 0; i < SHOT_MAX; i++)
+  {
+    addShot(4 + 20*i);
+    phase.play.shotY[i] = BRICKS_BOTTOM - 3 + SHOT_SPEED;
+  }
+  moveShots();
+}
+
+//A frame of chain reaction in a full wall of explosive bricks: every
+//blast finds all eight neighbours standing
+void benchBlasts()
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    phase.play.bricks[row] = FULL_ROW;
+    phase.play.explosive[row] = FULL_ROW;
+  }
+  phase.play.hitCount = 0;
+  phase.play.blastHead = 0;
+  phase.play.blastCount = BLASTS_PER_FRAME;
+  for (byte i = 0; i < BLASTS_PER_FRAME; i++)
+  {
+    phase.play.blastQueue[i] = ((1 + (i & 1)) << 4) | (2 + 4*i);
+  }
+  spreadBlasts();
+}
+
+//Dispatching two empty tasks, the scheduler's own cost each frame
+Task benchTasks[] =
+{
+  TASK(benchNothing, 0, 0xFFFF),
+  TASK(benchNothing, 0, 0xFFFF),
+};
+
+void benchRunTasks()
+{
+  runTasks(benchTasks, 2, micros() + 0xFFFF);
+}
+
+#ifdef PAGE_STRIP_RENDER
+//Recording and rasterizing a gameplay screen a page at a time
+void benchFrame()
+{
+  recordGameFrame(true);
+  stripRender(0, HEIGHT / 8 - 1, gamePage);
+}
+#else
+//Pushing the whole framebuffer, as a full-buffer frame ends
+void benchFrame()
+{
+  arduboy.display();
+}
+#endif
+
+void runBenchmarks()
+{
+  //Ball released at 1.5 speed, for the cases that don't place their own
+  enterPhase(PHASE_PLAY);
+  released = true;
+  xPaddle = 54;
+  dx = 2;
+  dy = -1;
+  benchOffset = 13;
+
+  benchOverhead = 0;
+  benchOverhead = benchCycles(benchNothing);
+
+  //What a frame leaves for game work once it has been drawn and pushed
+  unsigned int renderUs = benchMicros(benchFrame);
+  frameBudget = pgm_read_word(&FRAME_PERIODS[START_TIER]) - renderUs;
+
+  char line[22];
+  benchClear();
+  sprintf_P(line, PSTR("DRAW %u"), renderUs);
+  benchLine(line);
+  sprintf_P(line, PSTR("STEP %u SPIN %u"), benchCycles(benchStepBall), benchCycles(benchPaddleSpin));
+  benchLine(line);
+  benchReport(PSTR("MOVE "), benchCycles(benchMoveBall), MAX_CATCHUP);
+  benchReport(PSTR("TASKS "), benchCycles(benchRunTasks), 1);
+  benchReport(PSTR("DROPS "), benchCycles(benchPowerUps), MAX_CATCHUP);
+  benchReport(PSTR("SHOTS "), benchCycles(benchShots), MAX_CATCHUP);
+  benchReport(PSTR("BLAST "), benchCycles(benchBlasts), 1);
+  sprintf_P(line, PSTR("RAM T%u P%u I%u"), (unsigned int)sizeof(TitleState),
+            (unsigned int)sizeof(PlayState), (unsigned int)sizeof(InitialsState));
+  benchLine(line);
+  benchGameTasks();
+  while (true);
+}
+#endif
+
+
+Script script;                //State of the running sequence
+byte (*sequence)(Script *);   //Sequence that has the frames, or NULL
+
+void startSequence(byte (*fn)(Script *))
+{
+  sequence = fn;
+  script.line = 0;
+}
+
+//Plays the level tune out over the empty wall, then deals the next one
+byte levelClearSequence(Script *s)
+{
+  SCRIPT_BEGIN(s);
+  playScore(levelClearScore);
+  SCRIPT_WAIT_UNTIL(s, !scorePlaying());
+  level++;
+  newLevel();
+  SCRIPT_END(s);
+}
+
+//Shows game over, takes any high score, then resets for the title
+byte gameOverSequence(Script *s)
+{
+  SCRIPT_BEGIN(s);
+  drawGameOver();
+  SCRIPT_WAIT_MS(s, 4000);
+  if (score > 0)
+  {
+    enterHighScore(2);
+  }
+
+#ifndef PAGE_STRIP_RENDER
+  arduboy.clear();
+#endif
+  initialDraw=false;
+  start=false;
+  lives=3;
+  score=0;
+  enterPhase(PHASE_PLAY);
+  newLevel();
+  SCRIPT_END(s);
+}
+
+//Paddle, ball and bricks
+void taskPhysics()
+{
+  byte steps = physicsSteps();
+  drawPaddle(steps);
+
+  //Pause game if FIRE pressed
+  pad = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
+
+  if(pad >1 && oldpad==0 && released)
+  {
+    oldpad2=0; //Forces pad loop 2 to run once
+    pause();
+  }
+
+  oldpad=pad;
+  drawBall(steps);
+
+  if(wallCleared())
+  {
+    startSequence(levelClearSequence);
+  }
+}
+
+//Lives and score text, only redrawn when they have changed
+void taskHud()
+{
+  if (phase.play.hudDirty & HUD_LIVES)
+  {
+    drawLives();
+  }
+  if (phase.play.hudDirty & HUD_SCORE)
+  {
+    drawScore();
+  }
+  phase.play.hudDirty = 0;
+}
+
+//Gameplay tasks, most important first: period (ms), budget (us)
+Task gameTasks[] =
+{
+  TASK(taskPhysics, 0, 4000),
+  TASK(taskHud, 100, 1500),
+};
+const byte TASK_COUNT = sizeof(gameTasks) / sizeof(gameTasks[0]);
+const unsigned int DISPLAY_US = 2000; //Left at the end of a frame for the display push
+
+#ifdef BENCHMARK
+const byte BENCH_PLAY_FRAMES = 60;   //Frames of play the task accounting covers
+PROGMEM const char BENCH_TASK_NAMES[][5] = {"PHYS", "HUD "};
+static_assert(sizeof(BENCH_TASK_NAMES) / sizeof(BENCH_TASK_NAMES[0]) == TASK_COUNT, "benchmark name missing for a task");
+
+//Plays a second of a new level through the game's task table, with the
+//HUD redrawn every run, then once FIRE is pressed shows each task's
+//longest run and how often it went over budget or had to wait
+void benchGameTasks()
+{
+  unsigned int period = pgm_read_word(&FRAME_PERIODS[START_TIER]);
+  char line[22];
+
+  newLevel();
+  released = true;
+  dx = 1;
+  dy = -1;
+  resetTasks(gameTasks, TASK_COUNT);
+  for (byte frame = 0; frame < BENCH_PLAY_FRAMES; frame++)
+  {
+    unsigned long frameStart = micros();
+    phase.play.hudDirty = HUD_LIVES | HUD_SCORE;
+    runTasks(gameTasks, TASK_COUNT, frameStart + period - DISPLAY_US);
+    long left = frameStart + period - micros();
+    if (left > 0)
+    {
+      delay(left / 1000);
+    }
+  }
+
+  while (!(arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON)))
+  {
+    delay(10);
+  }
+  benchClear();
+  strcpy_P(line, PSTR("TASK WORST OVER LATE"));
+  benchLine(line);
+  for (byte i = 0; i < TASK_COUNT; i++)
+  {
+    strcpy_P(line, BENCH_TASK_NAMES[i]);
+    sprintf_P(line + strlen(line), PSTR(" %5u %4u %4u"), gameTasks[i].worst,
+              gameTasks[i].overruns, gameTasks[i].deferred);
+    benchLine(line);
+  }
+}
+#endif
 
 void setup()
 {
   arduboy.begin();
-  arduboy.setFrameRate(60);
-  arduboy.print("Hello World!");
+#ifndef PAGE_STRIP_RENDER
+  drawBegin(arduboy.getBuffer());
+#endif
+#ifdef BENCHMARK
+  runBenchmarks();
+#endif
+  setFrameTier(START_TIER);
+#ifdef PAGE_STRIP_RENDER
+  stripBegin();
+  stripTextP(0, 0, STR_HELLO);
+  stripRender(0, HEIGHT / 8 - 1, 0);
+#else
+  drawTextP(0, 0, STR_HELLO);
   arduboy.display();
-  intro();
+#endif
+  startSequence(introSequence);
 }
 
 
@@ -671,69 +2658,60 @@ void loop()
   // pause render until it's time for the next frame
   if (!(arduboy.nextFrame()))
     return;
+  unsigned long frameStart = micros();
+
+  //A running sequence has the frame to itself
+  if (sequence)
+  {
+    if (sequence(&script) == SCRIPT_RUNNING)
+      return;
+    sequence = NULL;
+  }
 
-  //Title screen loop switches from title screen
+  //Title screen switches from title screen
   //and high scores until FIRE is pressed
-  while (!start)
+  if (!start)
   {
-    start = titleScreen();
-    if (!start)
-    {
-      start = displayHighScores(2);
-    }
+    startSequence(titleSequence);
+    return;
   }
 
   //Initial level draw
   if (!initialDraw)
   {
     //Clears the screen
+#ifndef PAGE_STRIP_RENDER
     arduboy.display();
     arduboy.clear();
+#endif
     //Selects Font
     //Draws the new level
+    enterPhase(PHASE_PLAY);
     newLevel();
+    resetTasks(gameTasks, TASK_COUNT);
     initialDraw=true;
   }
 
   if (lives>0)
   {
-    drawPaddle();
-
-    //Pause game if FIRE pressed
-    pad = arduboy.pressed(A_BUTTON) || arduboy.pressed(B_BUTTON);
-
-    if(pad >1 && oldpad==0 && released)
-    {
-      oldpad2=0; //Forces pad loop 2 to run once
-      pause();
-    }
-
-    oldpad=pad;
-    drawBall();
-
-    if(brickCount == ROWS * COLUMNS)
-    {
-      level++;
-      newLevel();
-    }
+    //Whatever the tasks don't finish before the display push waits
+    runTasks(gameTasks, TASK_COUNT, frameStart + pgm_read_word(&FRAME_PERIODS[frameTier]) - DISPLAY_US);
+    adaptFrameRate();
   }
   else
   {
-    drawGameOver();
-    if (score > 0)
-    {
-      enterHighScore(2);
-    }
-
-    arduboy.clear();
-    initialDraw=false;
-    start=false;
-    lives=3;
-    score=0;
-    newLevel();
+    //Due times and counters start over with the next game
+    resetTasks(gameTasks, TASK_COUNT);
+    startSequence(gameOverSequence);
+    return;
   }
 
+#ifdef PAGE_STRIP_RENDER
+  recordGameFrame(true);
+  stripRender(0, HEIGHT / 8 - 1, gamePage);
+#else
   arduboy.display();
+#endif
 }
 
 
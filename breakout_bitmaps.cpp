@@ -122,3 +122,32 @@ PROGMEM const unsigned char arrow[] =
   0x10,
   0x20,
 };
+
+// The ball is stored as 8 pre-shifted copies, one for each y offset
+// within a page. Each copy holds two bytes per column, the part that lands
+// in the sprite's top page and the part that spills into the page below,
+// so drawing at any y is two byte writes per column with no shifting.
+// The copies are generated here at compile time from the column data.
+
+#define SHIFT_COLUMN(column, shift) \
+  (unsigned char)((column) << (shift)), (unsigned char)((column) >> (8 - (shift))),
+#define SHIFT_0(column) SHIFT_COLUMN(column, 0)
+#define SHIFT_1(column) SHIFT_COLUMN(column, 1)
+#define SHIFT_2(column) SHIFT_COLUMN(column, 2)
+#define SHIFT_3(column) SHIFT_COLUMN(column, 3)
+#define SHIFT_4(column) SHIFT_COLUMN(column, 4)
+#define SHIFT_5(column) SHIFT_COLUMN(column, 5)
+#define SHIFT_6(column) SHIFT_COLUMN(column, 6)
+#define SHIFT_7(column) SHIFT_COLUMN(column, 7)
+#define PRESHIFT(COLUMNS) \
+  COLUMNS(SHIFT_0) COLUMNS(SHIFT_1) COLUMNS(SHIFT_2) COLUMNS(SHIFT_3) \
+  COLUMNS(SHIFT_4) COLUMNS(SHIFT_5) COLUMNS(SHIFT_6) COLUMNS(SHIFT_7)
+
+// Columns, bit 0 at the top
+#define BALL_COLUMNS(S) S(0x03) S(0x03)
+
+PROGMEM const unsigned char ballShifted[] =
+{
+  2,2,
+  PRESHIFT(BALL_COLUMNS)
+};
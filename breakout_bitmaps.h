@@ -7,4 +7,7 @@ extern const unsigned char fire[];
 extern const unsigned char title[];
 extern const unsigned char arrow[];
 
+// Pre-shifted copy, drawn with drawSpriteShifted()
+extern const unsigned char ballShifted[];
+
 #endif
\ No newline at end of file
@@ -0,0 +1,297 @@
+#include <SPI.h>
+#include "Arduboy.h"
+#include "breakout_draw.h"
+#include "breakout_font.h"
+
+unsigned char *frameBuffer;
+
+byte pageBits(int top, int bottom, byte page)
+{
+  int pageTop = page << 3;
+  byte bits = 0xFF;
+
+  if (bottom < pageTop || top > pageTop + 7)
+  {
+    return 0;
+  }
+  if (top > pageTop)
+  {
+    bits <<= top - pageTop;
+  }
+  if (bottom < pageTop + 7)
+  {
+    bits &= 0xFF >> (pageTop + 7 - bottom);
+  }
+  return bits;
+}
+
+// Sets, clears or flips bits in columns x to x+w-1 of one page
+static void writeColumns(unsigned char *p, byte w, byte bits, byte color)
+{
+  if (color == DRAW_INVERT)
+  {
+    while (w--)
+    {
+      *p++ ^= bits;
+    }
+  }
+  else if (color)
+  {
+    while (w--)
+    {
+      *p++ |= bits;
+    }
+  }
+  else
+  {
+    bits = ~bits;
+    while (w--)
+    {
+      *p++ &= bits;
+    }
+  }
+}
+
+void drawBegin(unsigned char *buffer)
+{
+  frameBuffer = buffer;
+}
+
+// Limits the following display data to columns x0-x1 of pages
+// page0-page1, then switches back to data mode
+void setDisplayWindow(byte x0, byte x1, byte page0, byte page1)
+{
+  ArduboyCore::LCDCommandMode();
+  SPI.transfer(0x21); // column address
+  SPI.transfer(x0);
+  SPI.transfer(x1);
+  SPI.transfer(0x22); // page address
+  SPI.transfer(page0);
+  SPI.transfer(page1);
+  ArduboyCore::LCDDataMode();
+}
+
+// Sends just one rectangle of the framebuffer to the display, then
+// opens the window back up for the next full display()
+void displayRegion(byte x0, byte x1, byte page0, byte page1)
+{
+  setDisplayWindow(x0, x1, page0, page1);
+  for (byte page = page0; page <= page1; page++)
+  {
+    const unsigned char *p = frameBuffer + page * WIDTH;
+    for (byte x = x0; x <= x1; x++)
+    {
+      SPI.transfer(p[x]);
+    }
+  }
+  setDisplayWindow(0, WIDTH - 1, 0, HEIGHT / 8 - 1);
+}
+
+void drawPixelUnchecked(byte x, byte y, byte color)
+{
+  DRAW_ASSERT(x < WIDTH && y < HEIGHT);
+  writeColumns(frameBuffer + (y >> 3) * WIDTH + x, 1, 1 << (y & 7), color);
+}
+
+void drawHLineUnchecked(byte x, byte y, byte w, byte color)
+{
+  DRAW_ASSERT(w > 0 && x + w <= WIDTH && y < HEIGHT);
+  writeColumns(frameBuffer + (y >> 3) * WIDTH + x, w, 1 << (y & 7), color);
+}
+
+void fillRectUnchecked(byte x, byte y, byte w, byte h, byte color)
+{
+  byte bottom = y + h - 1;
+
+  DRAW_ASSERT(w > 0 && h > 0 && x + w <= WIDTH && y + h <= HEIGHT);
+  for (byte page = y >> 3; page <= bottom >> 3; page++)
+  {
+    writeColumns(frameBuffer + page * WIDTH + x, w,
+                 pageBits(y, bottom, page), color);
+  }
+}
+
+void drawRectUnchecked(byte x, byte y, byte w, byte h, byte color)
+{
+  byte bottom = y + h - 1;
+
+  DRAW_ASSERT(w > 0 && h > 0 && x + w <= WIDTH && y + h <= HEIGHT);
+  drawHLineUnchecked(x, y, w, color);
+  drawHLineUnchecked(x, bottom, w, color);
+  fillRectUnchecked(x, y, 1, h, color);
+  fillRectUnchecked(x + w - 1, y, 1, h, color);
+}
+
+// Moves rows top to bottom-n down by n (1 to 7) across the whole width,
+// clearing the n rows left at the top. Pages go bottom up so each one
+// still reads the page above before it has moved.
+void shiftRowsDown(byte top, byte bottom, byte n)
+{
+  DRAW_ASSERT(n > 0 && n < 8 && top + n <= bottom && bottom < HEIGHT);
+  byte firstPage = top >> 3;
+
+  for (byte page = bottom >> 3; page >= firstPage && page != 0xFF; page--)
+  {
+    byte bits = pageBits(top, bottom, page);
+    byte aboveBits = page > firstPage ? pageBits(top, bottom, page - 1) : 0;
+    unsigned char *p = frameBuffer + page * WIDTH;
+
+    for (byte x = 0; x < WIDTH; x++, p++)
+    {
+      byte moved = (*p & bits) << n;
+      if (aboveBits)
+      {
+        moved |= (p[-WIDTH] & aboveBits) >> (8 - n);
+      }
+      *p = (*p & ~bits) | (moved & bits);
+    }
+  }
+}
+
+// Draws a pre-shifted sprite (see breakout_bitmaps.cpp). Rows that
+// spill past the bottom of the screen are dropped.
+void drawSpriteShifted(byte x, byte y, const unsigned char *sprite, byte color)
+{
+  byte w = pgm_read_byte(sprite);
+  const unsigned char *data = sprite + 2 + (y & 7) * w * 2;
+  unsigned char *top = frameBuffer + (y >> 3) * WIDTH + x;
+  unsigned char *below = top + WIDTH;
+  boolean spill = (y >> 3) < HEIGHT / 8 - 1;
+
+  DRAW_ASSERT(x + w <= WIDTH && y < HEIGHT);
+  for (byte i = 0; i < w; i++)
+  {
+    byte upper = pgm_read_byte(data++);
+    byte lower = pgm_read_byte(data++);
+    if (color)
+    {
+      top[i] |= upper;
+      if (spill)
+      {
+        below[i] |= lower;
+      }
+    }
+    else
+    {
+      top[i] &= ~upper;
+      if (spill)
+      {
+        below[i] &= ~lower;
+      }
+    }
+  }
+}
+
+void drawGlyph(int x, int y, char c)
+{
+  const unsigned char *glyph = 0;
+  int page = y >> 3;
+  byte shift = y & 7;
+  unsigned char *top = frameBuffer + page * WIDTH;
+  unsigned char *below = top + WIDTH;
+  boolean drawTop = page >= 0 && page < HEIGHT / 8;
+  boolean drawBelow = shift && page >= -1 && page < HEIGHT / 8 - 1;
+
+  if (c >= FONT_FIRST_CHAR && c <= FONT_LAST_CHAR)
+  {
+    glyph = font5x7 + (c - FONT_FIRST_CHAR) * FONT_WIDTH;
+  }
+
+  for (byte i = 0; i <= FONT_WIDTH; i++, x++)
+  {
+    byte column = (glyph && i < FONT_WIDTH) ? pgm_read_byte(glyph + i) : 0;
+
+    if (x < 0 || x >= WIDTH)
+    {
+      continue;
+    }
+    if (shift == 0)
+    {
+      // Aligned: the glyph column is the framebuffer byte
+      if (drawTop)
+      {
+        top[x] = column;
+      }
+      continue;
+    }
+    if (drawTop)
+    {
+      top[x] = (top[x] & ~(0xFF << shift)) | (column << shift);
+    }
+    if (drawBelow)
+    {
+      below[x] = (below[x] & ~(0xFF >> (8 - shift))) | (column >> (8 - shift));
+    }
+  }
+}
+
+void drawText(int x, int y, const char *text)
+{
+  for (; *text; text++, x += FONT_WIDTH + 1)
+  {
+    drawGlyph(x, y, *text);
+  }
+}
+
+void drawTextP(int x, int y, PGM_P text)
+{
+  char c;
+
+  while ((c = pgm_read_byte(text++)))
+  {
+    drawGlyph(x, y, c);
+    x += FONT_WIDTH + 1;
+  }
+}
+
+void drawGlyph2x(int x, int y, char c)
+{
+  const unsigned char *glyph = 0;
+  int page = y >> 3;
+  byte shift = y & 7;
+  unsigned long mask = 0xFFFFUL << shift;
+
+  if (c >= FONT_FIRST_CHAR && c <= FONT_LAST_CHAR)
+  {
+    glyph = font5x7 + (c - FONT_FIRST_CHAR) * FONT_WIDTH;
+  }
+
+  for (byte i = 0; i <= FONT_WIDTH; i++, x += 2)
+  {
+    byte column = (glyph && i < FONT_WIDTH) ? pgm_read_byte(glyph + i) : 0;
+    unsigned long bits =
+      ((unsigned long)pgm_read_byte(doubledNibble + (column >> 4)) << 8 |
+       pgm_read_byte(doubledNibble + (column & 0x0F))) << shift;
+
+    // Two screen columns per glyph column, over the 2 or 3 pages it spans
+    for (byte j = 0; j < 2; j++)
+    {
+      int cx = x + j;
+      if (cx < 0 || cx >= WIDTH)
+      {
+        continue;
+      }
+      for (byte k = 0; k < 3; k++)
+      {
+        int p = page + k;
+        byte pageMask = mask >> (k * 8);
+        if (pageMask && p >= 0 && p < HEIGHT / 8)
+        {
+          unsigned char *b = frameBuffer + p * WIDTH + cx;
+          *b = (*b & ~pageMask) | (byte)(bits >> (k * 8));
+        }
+      }
+    }
+  }
+}
+
+void drawText2xP(int x, int y, PGM_P text)
+{
+  char c;
+
+  while ((c = pgm_read_byte(text++)))
+  {
+    drawGlyph2x(x, y, c);
+    x += (FONT_WIDTH + 1) * 2;
+  }
+}
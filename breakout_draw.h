@@ -0,0 +1,51 @@
+#ifndef BREAKOUT_DRAW_H
+#define BREAKOUT_DRAW_H
+
+#include <Arduino.h>
+
+// Framebuffer primitives without clipping, for objects the game keeps
+// on screen. Passing anything off screen writes outside the buffer, so
+// builds with DRAW_CHECKS defined (all non-AVR builds, such as the one in
+// host/) assert on every coordinate instead.
+
+#if !defined(__AVR__) && !defined(DRAW_CHECKS)
+#define DRAW_CHECKS
+#endif
+
+#ifdef DRAW_CHECKS
+#include <assert.h>
+#define DRAW_ASSERT(condition) assert(condition)
+#else
+#define DRAW_ASSERT(condition)
+#endif
+
+// Color that flips pixels, so drawing the same shape twice puts back
+// whatever was underneath
+#define DRAW_INVERT 2
+
+extern unsigned char *frameBuffer;
+
+// Bits of rows top to bottom (inclusive) that fall inside page, 0 if none
+byte pageBits(int top, int bottom, byte page);
+
+void drawBegin(unsigned char *buffer);
+void setDisplayWindow(byte x0, byte x1, byte page0, byte page1);
+void displayRegion(byte x0, byte x1, byte page0, byte page1);
+void drawPixelUnchecked(byte x, byte y, byte color);
+void drawHLineUnchecked(byte x, byte y, byte w, byte color);
+void fillRectUnchecked(byte x, byte y, byte w, byte h, byte color);
+void drawRectUnchecked(byte x, byte y, byte w, byte h, byte color);
+void drawSpriteShifted(byte x, byte y, const unsigned char *sprite, byte color);
+void shiftRowsDown(byte top, byte bottom, byte n);
+
+// Text in the 5x7 font, drawn opaque in 6x8 cells like print(). These
+// clip, and at y positions on a page boundary each glyph column is a
+// single byte store. The 2x versions match setTextSize(2), expanding
+// each glyph column through a nibble doubling table.
+void drawGlyph(int x, int y, char c);
+void drawText(int x, int y, const char *text);
+void drawTextP(int x, int y, PGM_P text);
+void drawGlyph2x(int x, int y, char c);
+void drawText2xP(int x, int y, PGM_P text);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef BREAKOUT_FONT_H
+#define BREAKOUT_FONT_H
+
+#include <avr/pgmspace.h>
+
+#define FONT_FIRST_CHAR 32
+#define FONT_LAST_CHAR 126
+#define FONT_WIDTH 5
+
+extern const unsigned char font5x7[];
+extern const unsigned char doubledNibble[];
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef BREAKOUT_SCRIPT_H
+#define BREAKOUT_SCRIPT_H
+
+#include <Arduino.h>
+
+// Stackless coroutines for timed sequences. A script is a function that
+// takes a Script and is called once a frame until it returns SCRIPT_DONE.
+// SCRIPT_BEGIN opens a switch on the line the script last waited at, so
+// each call jumps straight back to where it left off; nothing lives on
+// the stack between frames.
+//
+// Locals don't survive a wait: keep loop counters in the Script or in
+// phase state. Only one wait may be written per source line, and waits
+// can't be made from inside a nested switch.
+
+#define SCRIPT_RUNNING 0
+#define SCRIPT_DONE 1
+
+struct Script
+{
+  unsigned int line;    // where to resume, 0 to start from the top
+  unsigned long timer;  // millis() a timed wait started at
+  int count;            // loop counter that survives waits
+};
+
+#define SCRIPT_BEGIN(s) switch ((s)->line) { case 0:
+
+#define SCRIPT_END(s) } (s)->line = 0; return SCRIPT_DONE
+
+// Finishes the script early
+#define SCRIPT_EXIT(s) do { (s)->line = 0; return SCRIPT_DONE; } while (0)
+
+// Gives up the rest of this frame
+#define SCRIPT_YIELD(s) \
+  do { (s)->line = __LINE__; return SCRIPT_RUNNING; case __LINE__:; } while (0)
+
+// Waits, checking once a frame, until cond is true. Doesn't yield if it
+// already is.
+#define SCRIPT_WAIT_UNTIL(s, cond) \
+  do { (s)->line = __LINE__; case __LINE__: \
+    if (!(cond)) return SCRIPT_RUNNING; } while (0)
+
+#define SCRIPT_ELAPSED(s) (millis() - (s)->timer)
+
+#define SCRIPT_WAIT_MS(s, ms) \
+  do { (s)->timer = millis(); \
+    SCRIPT_WAIT_UNTIL(s, SCRIPT_ELAPSED(s) >= (ms)); } while (0)
+
+#endif
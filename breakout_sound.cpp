@@ -0,0 +1,190 @@
+#include "Arduboy.h"
+#include <util/atomic.h>
+#include "breakout_sound.h"
+
+struct ToneTiming
+{
+  byte clockSelect;  // Timer4 CS4 bits, prescaler of 2^(n-1)
+  unsigned int top;  // OCR4C, 10 bits
+  unsigned int rate; // Output toggles per ms, 8.8 fixed point
+};
+
+// Timer ticks between toggles of a tone at frequency Hz
+constexpr unsigned long toneTicks(unsigned long frequency)
+{
+  return F_CPU / (2 * frequency);
+}
+
+// Smallest prescaler that brings ticks within the 10 bit counter
+constexpr byte toneClock(unsigned long ticks, byte clockSelect = 1)
+{
+  return (ticks >> (clockSelect - 1)) <= 1024 ?
+    clockSelect : toneClock(ticks, clockSelect + 1);
+}
+
+#define TONE_TIMING(frequency) \
+  { \
+    toneClock(toneTicks(frequency)), \
+    (unsigned int)((toneTicks(frequency) >> \
+      (toneClock(toneTicks(frequency)) - 1)) - 1), \
+    (unsigned int)((frequency) * 512UL / 1000) \
+  }
+
+PROGMEM static const ToneTiming toneTable[] =
+{
+  TONE_TIMING(175),
+  TONE_TIMING(200),
+  TONE_TIMING(261),
+  TONE_TIMING(523),
+  TONE_TIMING(987),
+  TONE_TIMING(1046),
+  TONE_TIMING(1318),
+  TONE_TIMING(330),
+  TONE_TIMING(392),
+  TONE_TIMING(659),
+  TONE_TIMING(784),
+  TONE_TIMING(500), // TONE_REST, timed with the speaker disconnected
+};
+
+#define TONE_REST (sizeof(toneTable) / sizeof(toneTable[0]) - 1)
+
+PROGMEM const byte introScore[] =
+{
+  TONE_987, 16,
+  TONE_1318, 40,
+  SCORE_END
+};
+
+PROGMEM const byte levelClearScore[] =
+{
+  TONE_523, 8,
+  TONE_659, 8,
+  TONE_784, 8,
+  SCORE_REST, 4,
+  TONE_784, 6,
+  TONE_1046, 30,
+  SCORE_END
+};
+
+PROGMEM const byte gameOverScore[] =
+{
+  TONE_392, 15,
+  TONE_330, 15,
+  TONE_261, 15,
+  SCORE_REST, 5,
+  TONE_175, 50,
+  SCORE_END
+};
+
+static volatile unsigned int toggles; // Left before the tone ends
+static const byte *volatile scoreCursor; // Next score pair, 0 if none
+
+// Runs the timer for tone over duration ms, returns false if too short
+static boolean startTimer(byte tone, unsigned int duration, boolean audible)
+{
+  const ToneTiming *timing = &toneTable[tone];
+  unsigned int top = pgm_read_word(&timing->top);
+  unsigned int count =
+    ((unsigned long)duration * pgm_read_word(&timing->rate)) >> 8;
+
+  TCCR4B = 0;
+  if (count == 0)
+  {
+    return false;
+  }
+  toggles = count;
+  TC4H = top >> 8;
+  OCR4C = top;
+  TC4H = 0;
+  OCR4A = 0;
+  TCNT4 = 0;
+  TCCR4D = 0;
+  // toggle OC4A, the speaker pin, every cycle
+  TCCR4A = audible ? _BV(COM4A0) : 0;
+  DDRC |= _BV(PC7);
+  TIFR4 = _BV(TOV4);
+  TIMSK4 |= _BV(TOIE4);
+  TCCR4B = pgm_read_byte(&timing->clockSelect);
+  return true;
+}
+
+// Starts the next note of the score, called when the last one ends
+static void stepScore()
+{
+  byte tone;
+  byte duration;
+
+  do
+  {
+    tone = pgm_read_byte(scoreCursor);
+    if (tone == SCORE_END)
+    {
+      scoreCursor = 0;
+      stopTone();
+      return;
+    }
+    duration = pgm_read_byte(scoreCursor + 1);
+    scoreCursor += 2;
+  }
+  while (!startTimer(tone == SCORE_REST ? TONE_REST : tone,
+                     duration * 10, tone != SCORE_REST));
+}
+
+// Starts tone for duration ms, replacing any tone or score playing
+void playTone(byte tone, unsigned int duration)
+{
+  if (!ArduboyAudio::enabled())
+  {
+    return;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    scoreCursor = 0;
+    if (!startTimer(tone, duration, true))
+    {
+      stopTone();
+    }
+  }
+}
+
+// Starts a score in flash, replacing any tone or score playing
+void playScore(const byte *newScore)
+{
+  if (!ArduboyAudio::enabled())
+  {
+    return;
+  }
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    scoreCursor = newScore;
+    stepScore();
+  }
+}
+
+boolean scorePlaying()
+{
+  return scoreCursor != 0;
+}
+
+void stopTone()
+{
+  TCCR4B = 0;
+  TCCR4A = 0;
+  TIMSK4 &= ~_BV(TOIE4);
+  PORTC &= ~_BV(PC7);
+}
+
+ISR(TIMER4_OVF_vect)
+{
+  if (--toggles == 0)
+  {
+    if (scoreCursor)
+    {
+      stepScore();
+    }
+    else
+    {
+      stopTone();
+    }
+  }
+}
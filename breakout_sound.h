@@ -0,0 +1,39 @@
+#ifndef BREAKOUT_SOUND_H
+#define BREAKOUT_SOUND_H
+
+#include <Arduino.h>
+
+// Game tones, played by Timer4 toggling the speaker pin in hardware.
+// The timer settings for each tone are worked out at compile time, so
+// starting one is a handful of register writes with no division.
+//
+// Scores are byte pairs in flash: a tone (or SCORE_REST) and how long
+// it lasts in 10 ms units, finished by SCORE_END. The Timer4 interrupt
+// steps to the next pair when a note ends, a fixed amount of work per
+// note, so playback takes no time from loop().
+
+#define TONE_175 0
+#define TONE_200 1
+#define TONE_261 2
+#define TONE_523 3
+#define TONE_987 4
+#define TONE_1046 5
+#define TONE_1318 6
+#define TONE_330 7
+#define TONE_392 8
+#define TONE_659 9
+#define TONE_784 10
+
+#define SCORE_REST 0xFE
+#define SCORE_END 0xFF
+
+extern const byte introScore[];
+extern const byte levelClearScore[];
+extern const byte gameOverScore[];
+
+void playTone(byte tone, unsigned int duration);
+void stopTone();
+void playScore(const byte *score);
+boolean scorePlaying();
+
+#endif
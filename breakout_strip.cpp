@@ -0,0 +1,354 @@
+#include <SPI.h>
+#include "breakout_strip.h"
+#include "breakout_draw.h"
+#include "breakout_font.h"
+
+#define OP_FILL 0
+#define OP_RECT_ROW 1
+#define OP_FILL_ROW 2
+#define OP_TEXT 3
+#define OP_TEXT_P 4
+#define OP_TEXT_2X_P 5
+#define OP_GLYPH 6
+
+struct StripOp
+{
+  byte type;
+  byte x;
+  signed char y;      // Text can start above the screen
+  byte w;
+  byte h;
+  byte pitch;
+  union
+  {
+    unsigned int mask;  // OP_RECT_ROW, OP_FILL_ROW: bit n draws rect n
+    const char *text;   // OP_TEXT: must stay valid until stripRender()
+                        // OP_TEXT_P, OP_TEXT_2X_P: in flash
+    char glyph;         // OP_GLYPH
+  };
+};
+
+static StripOp ops[STRIP_MAX_OPS];
+static byte opCount;
+static byte strip[WIDTH];
+static byte renderPage;   // Page stripRender() is rasterizing
+
+// Drops operations that are off screen or don't fit in the list
+static StripOp *addOp(byte type, int x, int y, byte w, byte h)
+{
+  if (opCount == STRIP_MAX_OPS || x < 0 || y + h <= 0 ||
+      x >= WIDTH || y >= HEIGHT)
+  {
+    return 0;
+  }
+  StripOp *op = &ops[opCount++];
+  op->type = type;
+  op->x = x;
+  op->y = y;
+  op->w = w;
+  op->h = h;
+  return op;
+}
+
+// ORs a w column rect into the strip, sides get edge, the rest inner
+static void rasterRect(byte x, byte w, byte edge, byte inner)
+{
+  byte last = x + w - 1;
+
+  if (last >= WIDTH)
+  {
+    last = WIDTH - 1;
+  }
+  strip[x] |= edge;
+  for (byte i = x + 1; i < last; i++)
+  {
+    strip[i] |= inner;
+  }
+  if (last > x)
+  {
+    strip[last] |= edge;
+  }
+}
+
+// Character i of a text operation, 0 past the end
+static char opChar(const StripOp *op, byte i)
+{
+  if (op->type == OP_GLYPH)
+  {
+    return i ? 0 : op->glyph;
+  }
+  if (op->type == OP_TEXT)
+  {
+    return op->text[i];
+  }
+  return pgm_read_byte(op->text + i);
+}
+
+// Column i of the glyph for c, blank outside the font
+static byte glyphColumn(char c, byte i)
+{
+  if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR)
+  {
+    return 0;
+  }
+  return pgm_read_byte(font5x7 + (c - FONT_FIRST_CHAR) * FONT_WIDTH + i);
+}
+
+static void rasterText(const StripOp *op, byte page)
+{
+  int shift = op->y - (page << 3);
+  byte x = op->x;
+  char c;
+
+  if (shift <= -8 || shift >= 8)
+  {
+    return;
+  }
+  for (byte i = 0; x < WIDTH && (c = opChar(op, i)); i++)
+  {
+    for (byte j = 0; j < FONT_WIDTH && x < WIDTH; j++, x++)
+    {
+      byte column = glyphColumn(c, j);
+      strip[x] |= (shift >= 0) ? column << shift : column >> -shift;
+    }
+    x++;
+  }
+}
+
+// Text at twice the size, each glyph column doubled through a nibble
+// table into 16 rows and two screen columns
+static void rasterText2x(const StripOp *op, byte page)
+{
+  int shift = op->y - (page << 3);
+  byte x = op->x;
+  char c;
+
+  if (shift <= -16 || shift >= 8)
+  {
+    return;
+  }
+  for (byte i = 0; x < WIDTH && (c = opChar(op, i)); i++)
+  {
+    for (byte j = 0; j < FONT_WIDTH && x < WIDTH; j++, x += 2)
+    {
+      byte column = glyphColumn(c, j);
+      unsigned int bits = pgm_read_byte(doubledNibble + (column >> 4)) << 8 |
+                          pgm_read_byte(doubledNibble + (column & 0x0F));
+      byte part = (shift >= 0) ? bits << shift : bits >> -shift;
+      strip[x] |= part;
+      if (x + 1 < WIDTH)
+      {
+        strip[x + 1] |= part;
+      }
+    }
+    x += 2;
+  }
+}
+
+static void rasterOp(const StripOp *op, byte page)
+{
+  int bottom = op->y + op->h - 1;
+  byte edge;
+
+  if (op->type == OP_TEXT_2X_P)
+  {
+    rasterText2x(op, page);
+    return;
+  }
+  if (op->type >= OP_TEXT)
+  {
+    rasterText(op, page);
+    return;
+  }
+  edge = pageBits(op->y, bottom, page);
+  if (!edge)
+  {
+    return;
+  }
+
+  byte inner = edge;
+  if (op->type == OP_RECT_ROW)
+  {
+    inner = pageBits(op->y, op->y, page) | pageBits(bottom, bottom, page);
+  }
+  if (op->type == OP_FILL)
+  {
+    rasterRect(op->x, op->w, edge, inner);
+    return;
+  }
+
+  unsigned int mask = op->mask;
+  for (byte x = op->x; mask && x < WIDTH; x += op->pitch, mask >>= 1)
+  {
+    if (mask & 1)
+    {
+      rasterRect(x, op->w, edge, inner);
+    }
+  }
+}
+
+void stripBegin()
+{
+  opCount = 0;
+}
+
+void stripFill(int x, int y, byte w, byte h)
+{
+  addOp(OP_FILL, x, y, w, h);
+}
+
+void stripText(int x, int y, const char *text)
+{
+  StripOp *op = addOp(OP_TEXT, x, y, 0, 8);
+  if (op)
+  {
+    op->text = text;
+  }
+}
+
+void stripTextP(int x, int y, PGM_P text)
+{
+  StripOp *op = addOp(OP_TEXT_P, x, y, 0, 8);
+  if (op)
+  {
+    op->text = text;
+  }
+}
+
+void stripText2xP(int x, int y, PGM_P text)
+{
+  StripOp *op = addOp(OP_TEXT_2X_P, x, y, 0, 16);
+  if (op)
+  {
+    op->text = text;
+  }
+}
+
+void stripGlyph(int x, int y, char c)
+{
+  StripOp *op = addOp(OP_GLYPH, x, y, 0, 8);
+  if (op)
+  {
+    op->glyph = c;
+  }
+}
+
+// Immediate operations are built on the stack and rasterized at once
+static void rasterNow(byte type, int x, int y, byte w, byte h, byte pitch, unsigned int mask)
+{
+  StripOp op;
+
+  if (x < 0 || x >= WIDTH || y + h <= 0 || y >= HEIGHT)
+  {
+    return;
+  }
+  op.type = type;
+  op.x = x;
+  op.y = y;
+  op.w = w;
+  op.h = h;
+  op.pitch = pitch;
+  op.mask = mask;
+  rasterOp(&op, renderPage);
+}
+
+void stripPageRectRow(int x, int y, byte w, byte h, byte pitch, unsigned int mask)
+{
+  rasterNow(OP_RECT_ROW, x, y, w, h, pitch, mask);
+}
+
+void stripPageFillRow(int x, int y, byte w, byte h, byte pitch, unsigned int mask)
+{
+  rasterNow(OP_FILL_ROW, x, y, w, h, pitch, mask);
+}
+
+void stripPageText(int x, int y, const char *text)
+{
+  StripOp op;
+
+  if (x < 0 || x >= WIDTH || y + 8 <= 0 || y >= HEIGHT)
+  {
+    return;
+  }
+  op.type = OP_TEXT;
+  op.x = x;
+  op.y = y;
+  op.text = text;
+  rasterText(&op, renderPage);
+}
+
+// Sends pages page0 to page1, each built from the list and then the hook
+void stripRender(byte page0, byte page1, StripPageHook hook)
+{
+  setDisplayWindow(0, WIDTH - 1, page0, page1);
+
+  for (renderPage = page0; renderPage <= page1; renderPage++)
+  {
+    memset(strip, 0, WIDTH);
+
+    for (byte i = 0; i < opCount; i++)
+    {
+      rasterOp(&ops[i], renderPage);
+    }
+    if (hook)
+    {
+      hook(renderPage);
+    }
+
+    for (byte i = 0; i < WIDTH; i++)
+    {
+      SPI.transfer(strip[i]);
+    }
+  }
+  setDisplayWindow(0, WIDTH - 1, 0, HEIGHT / 8 - 1);
+}
+
+// Frame timing as the Arduboy class does it
+void StripArduboy::begin()
+{
+  boot();
+  blank();
+  audio.begin();
+}
+
+boolean StripArduboy::pressed(uint8_t buttons)
+{
+  return (buttonsState() & buttons) == buttons;
+}
+
+void StripArduboy::setFrameRate(uint8_t rate)
+{
+  eachFrameMillis = 1000 / rate;
+}
+
+boolean StripArduboy::nextFrame()
+{
+  unsigned long now = millis();
+
+  if (postRender)
+  {
+    lastFrameDurationMs = now - lastFrameStart;
+    postRender = false;
+  }
+
+  if (now < nextFrameStart)
+  {
+    // Sleep if there is more than a millisecond to spare, timer 0 wakes
+    // the CPU every millisecond
+    if (nextFrameStart - now > 1)
+    {
+      idle();
+    }
+    return false;
+  }
+
+  nextFrameStart = now + eachFrameMillis;
+  lastFrameStart = now;
+  postRender = true;
+  return true;
+}
+
+int StripArduboy::cpuLoad()
+{
+  return lastFrameDurationMs * 100 / eachFrameMillis;
+}
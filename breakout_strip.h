@@ -0,0 +1,54 @@
+#ifndef BREAKOUT_STRIP_H
+#define BREAKOUT_STRIP_H
+
+#include <Arduino.h>
+#include "Arduboy.h"
+
+// Display list for page-strip rendering. A frame is recorded as a short
+// list of draw operations, then rasterized one 8 pixel high page at a
+// time into a 128 byte strip that is sent straight to the display, so
+// no full 1 KB framebuffer is needed to build it.
+
+#define STRIP_MAX_OPS 16
+
+// Called for each page as it is rasterized, to draw what would take too
+// many operations to record, straight into the strip
+typedef void (*StripPageHook)(byte page);
+
+void stripBegin();
+void stripFill(int x, int y, byte w, byte h);
+void stripText(int x, int y, const char *text);
+void stripTextP(int x, int y, PGM_P text);
+void stripText2xP(int x, int y, PGM_P text);
+void stripGlyph(int x, int y, char c);
+void stripRender(byte page0, byte page1, StripPageHook hook);
+
+// Draw into the page being rasterized, only from a page hook. Rows of
+// rects are drawn every pitch pixels from x, one for each bit of mask.
+void stripPageRectRow(int x, int y, byte w, byte h, byte pitch, unsigned int mask);
+void stripPageFillRow(int x, int y, byte w, byte h, byte pitch, unsigned int mask);
+void stripPageText(int x, int y, const char *text);
+
+// Stands in for the Arduboy object when every frame is rendered in
+// strips. Buttons, frame timing and audio work as they do there, but
+// without the Arduboy class there is no 1 KB screen buffer in SRAM.
+class StripArduboy : public ArduboyCore
+{
+public:
+  void begin();
+  boolean pressed(uint8_t buttons);
+  void setFrameRate(uint8_t rate);
+  boolean nextFrame();
+  int cpuLoad();
+
+  ArduboyAudio audio;
+
+private:
+  uint8_t eachFrameMillis;
+  uint8_t lastFrameDurationMs;
+  unsigned long lastFrameStart;
+  unsigned long nextFrameStart;
+  boolean postRender;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "breakout_tasks.h"
+
+void resetTasks(Task *tasks, byte count)
+{
+  unsigned long now = millis();
+
+  for (byte i = 0; i < count; i++)
+  {
+    tasks[i].due = now;
+    tasks[i].overruns = 0;
+    tasks[i].deferred = 0;
+    tasks[i].worst = 0;
+  }
+}
+
+// deadline is the micros() time the frame's work has to be done by
+void runTasks(Task *tasks, byte count, unsigned long deadline)
+{
+  unsigned long now = millis();
+
+  for (byte i = 0; i < count; i++)
+  {
+    Task *task = &tasks[i];
+    unsigned long start, took;
+
+    if ((long)(now - task->due) < 0)
+    {
+      continue;
+    }
+
+    start = micros();
+    if (i > 0 && (long)(deadline - start) < (long)task->budget)
+    {
+      task->deferred++;
+      continue;
+    }
+
+    task->run();
+
+    took = micros() - start;
+    if (took > task->budget)
+    {
+      task->overruns++;
+    }
+    if (took > task->worst)
+    {
+      task->worst = took > 0xFFFF ? 0xFFFF : took;
+    }
+
+    // Periodic tasks keep their phase, unless they have fallen a whole
+    // period behind, then they skip ahead rather than run back to back
+    if (task->period > 0)
+    {
+      task->due += task->period;
+      if ((long)(now - task->due) >= 0)
+      {
+        task->due = now + task->period;
+      }
+    }
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef BREAKOUT_TASKS_H
+#define BREAKOUT_TASKS_H
+
+#include <Arduino.h>
+
+// Cooperative scheduler over a fixed table of tasks. Tasks are checked
+// in table order, so the most important goes first. Each has a period
+// in ms (0 runs it every frame) and a budget in us. A due task only
+// starts if its budget still fits before the frame's deadline, otherwise
+// it waits for a later frame; the first task is never held back. Runs
+// that take longer than their budget are counted as overruns. The
+// benchmark build plays a second of the game and shows the counts.
+
+struct Task
+{
+  void (*run)();
+  unsigned int period;    // ms between runs, 0 for every frame
+  unsigned int budget;    // us a run is expected to take
+  unsigned long due;      // millis() the next run is due
+  unsigned int overruns;  // runs that went over budget
+  unsigned int deferred;  // due runs pushed to a later frame
+  unsigned int worst;     // longest run seen, in us
+};
+
+#define TASK(run, period, budget) { run, period, budget, 0, 0, 0, 0 }
+
+void resetTasks(Task *tasks, byte count);
+void runTasks(Task *tasks, byte count, unsigned long deadline);
+
+#endif
@@ -0,0 +1,304 @@
+// Host stand-in for the Arduboy library and the parts of the Arduino
+// core the sketch uses. Time only moves when the sketch waits for it,
+// and Timer4's overflow interrupt is run as it passes, so scores play
+// out at their real length.
+#include <assert.h>
+#include <Arduboy.h>
+#include "host.h"
+
+SPIClass SPI;
+EEPROMClass EEPROM;
+
+volatile uint8_t TCCR1A, TCCR1B, DDRC, PORTC;
+volatile uint16_t TCNT1;
+volatile uint8_t TCCR4A, TCCR4B, TCCR4D, TC4H, OCR4A, OCR4C, TCNT4;
+volatile uint8_t TIFR4, TIMSK4;
+
+unsigned char hostScreen[HEIGHT / 8][WIDTH];
+unsigned long hostPushes;
+
+static unsigned long now;           // Microseconds since power on
+static uint8_t eeprom[1024];
+static bool commandMode;
+static uint8_t command[3];
+static uint8_t commandLength;
+static uint8_t column0 = 0, column1 = WIDTH - 1, column;
+static uint8_t page0 = 0, page1 = HEIGHT / 8 - 1, page;
+
+extern "C" void TIMER4_OVF_vect(void);
+
+// Moves the clock on, running the tone interrupt about as often as a
+// mid-range tone would overflow Timer4
+void hostAdvance(unsigned long us)
+{
+  for (unsigned long left = us; left >= 250; left -= 250)
+  {
+    now += 250;
+    if (TIMSK4 & _BV(TOIE4))
+    {
+      TIMER4_OVF_vect();
+    }
+  }
+  now += us % 250;
+}
+
+unsigned long millis()
+{
+  return now / 1000;
+}
+
+unsigned long micros()
+{
+  return now;
+}
+
+void delay(unsigned long ms)
+{
+  hostAdvance(ms * 1000);
+}
+
+long random(long howBig)
+{
+  return howBig ? rand() % howBig : 0;
+}
+
+long random(long howSmall, long howBig)
+{
+  return howSmall + random(howBig - howSmall);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+
+// Display controller: commands 0x21 and 0x22 set the column and page
+// window, data fills it column by column, then page by page
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  if (commandMode)
+  {
+    command[commandLength++] = data;
+    if (command[0] != 0x21 && command[0] != 0x22)
+    {
+      commandLength = 0;
+    }
+    else if (commandLength == 3)
+    {
+      assert(command[1] <= command[2]);
+      if (command[0] == 0x21)
+      {
+        assert(command[2] < WIDTH);
+        column0 = column = command[1];
+        column1 = command[2];
+      }
+      else
+      {
+        assert(command[2] < HEIGHT / 8);
+        page0 = page = command[1];
+        page1 = command[2];
+      }
+      commandLength = 0;
+    }
+    return 0;
+  }
+
+  hostScreen[page][column] = data;
+  if (column++ == column1)
+  {
+    column = column0;
+    if (page++ == page1)
+    {
+      page = page0;
+      hostPushes++;
+    }
+  }
+  return 0;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+  assert(address >= 0 && address < (int)sizeof(eeprom));
+  return eeprom[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+  assert(address >= 0 && address < (int)sizeof(eeprom));
+  eeprom[address] = value;
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+  write(address, value);
+}
+
+void hostEraseEEPROM()
+{
+  memset(eeprom, 0xFF, sizeof(eeprom));
+}
+
+void ArduboyAudio::begin() {}
+void ArduboyAudio::on() {}
+void ArduboyAudio::off() {}
+
+bool ArduboyAudio::enabled()
+{
+  return true;
+}
+
+void ArduboyCore::boot()
+{
+  hostEraseEEPROM();
+}
+
+void ArduboyCore::blank()
+{
+  for (int i = 0; i < WIDTH * HEIGHT / 8; i++)
+  {
+    SPI.transfer(0);
+  }
+}
+
+void ArduboyCore::idle()
+{
+  hostAdvance(1000);
+}
+
+void ArduboyCore::LCDDataMode()
+{
+  commandMode = false;
+}
+
+void ArduboyCore::LCDCommandMode()
+{
+  commandMode = true;
+  commandLength = 0;
+}
+
+uint8_t ArduboyCore::buttonsState()
+{
+  return hostButtons();
+}
+
+void ArduboyCore::paintScreen(const unsigned char *image)
+{
+  for (int i = 0; i < WIDTH * HEIGHT / 8; i++)
+  {
+    SPI.transfer(image[i]);
+  }
+}
+
+size_t Print::print(const char *s)
+{
+  size_t n = 0;
+  while (*s)
+  {
+    n += write(*s++);
+  }
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *s)
+{
+  return print(reinterpret_cast<const char *>(s));
+}
+
+size_t Print::print(unsigned int n)
+{
+  return print((unsigned long)n);
+}
+
+size_t Print::print(int n)
+{
+  char digits[8];
+  sprintf(digits, "%d", n);
+  return print(digits);
+}
+
+size_t Print::print(unsigned long n)
+{
+  char digits[12];
+  sprintf(digits, "%lu", n);
+  return print(digits);
+}
+
+void Arduboy::begin()
+{
+  boot();
+  blank();
+  audio.begin();
+  setFrameRate(60);
+}
+
+void Arduboy::clear()
+{
+  memset(sBuffer, 0, sizeof(sBuffer));
+}
+
+void Arduboy::display()
+{
+  paintScreen(sBuffer);
+}
+
+unsigned char *Arduboy::getBuffer()
+{
+  return sBuffer;
+}
+
+void Arduboy::fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color)
+{
+  for (int16_t i = x; i < x + w; i++)
+  {
+    for (int16_t j = y; j < y + h; j++)
+    {
+      if (i >= 0 && i < WIDTH && j >= 0 && j < HEIGHT)
+      {
+        unsigned char *p = &sBuffer[(j >> 3) * WIDTH + i];
+        *p = color ? *p | _BV(j & 7) : *p & ~_BV(j & 7);
+      }
+    }
+  }
+}
+
+void Arduboy::setCursor(int16_t, int16_t) {}
+
+// Text is checked through the sketch's own font routines, not this one
+size_t Arduboy::write(uint8_t)
+{
+  return 1;
+}
+
+bool Arduboy::pressed(uint8_t buttons)
+{
+  return (buttonsState() & buttons) == buttons;
+}
+
+void Arduboy::setFrameRate(uint8_t rate)
+{
+  eachFrameMillis = 1000 / rate;
+}
+
+// Waits out the rest of the frame, so every call starts one
+bool Arduboy::nextFrame()
+{
+  unsigned long ms = millis();
+
+  if (postRender)
+  {
+    lastFrameDurationMs = ms - lastFrameStart;
+    postRender = false;
+  }
+  if (ms < nextFrameStart)
+  {
+    hostAdvance((nextFrameStart - ms) * 1000);
+    ms = millis();
+  }
+  nextFrameStart = ms + eachFrameMillis;
+  lastFrameStart = ms;
+  postRender = true;
+  return true;
+}
+
+int Arduboy::cpuLoad()
+{
+  return lastFrameDurationMs * 100 / eachFrameMillis;
+}
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Checks a linked sketch for software divides on the per-frame path.
+Disassembles the ELF, follows every call and jump out of the root
+functions, and fails if any chain reaches one of libgcc's divide or
+modulo routines. Functions the compiler inlined are covered by their
+callers, so nothing needs listing beyond the roots.
+
+    divides.py ArduBreakout.ino.elf [root ...]
+
+OBJDUMP names the disassembler, avr-objdump by default."""
+import os
+import re
+import subprocess
+import sys
+
+# The physics task and the page strip renderer, which run every frame.
+# gamePage is only called through the renderer's page hook pointer, so
+# it is a root of its own. The HUD task formats numbers and is left out.
+ROOTS = ['taskPhysics', 'recordGameFrame', 'stripRender', 'gamePage']
+DIVIDES = re.compile(r'^__u?divmod[qhs]i4$')
+FUNCTION = re.compile(r'^[0-9a-f]+ <(.+)>:$')
+BRANCH = re.compile(r'\t(?:r?call|r?jmp)\t.*<([^>+]+)>$')
+
+
+def name(symbol):
+    """Bare function name from a demangled symbol."""
+    return symbol.split('(')[0]
+
+
+def calls(listing):
+    """Maps each function to the functions it calls or jumps to."""
+    graph = {}
+    current = None
+    for line in listing.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = graph.setdefault(name(match.group(1)), set())
+            continue
+        match = BRANCH.search(line)
+        if match and current is not None:
+            current.add(name(match.group(1)))
+    return graph
+
+
+def main(elf, roots):
+    objdump = os.environ.get('OBJDUMP', 'avr-objdump')
+    listing = subprocess.check_output([objdump, '-d', '-C', elf]).decode()
+    graph = calls(listing)
+
+    chains = {root: [root] for root in roots if root in graph}
+    if not chains:
+        sys.exit('%s: none of %s found' % (elf, ', '.join(roots)))
+    pending = list(chains)
+    found = False
+    while pending:
+        caller = pending.pop()
+        for callee in sorted(graph.get(caller, ())):
+            if callee in chains:
+                continue
+            chains[callee] = chains[caller] + [callee]
+            if DIVIDES.match(callee):
+                print('divide: ' + ' -> '.join(chains[callee]))
+                found = True
+            else:
+                pending.append(callee)
+
+    print('%d functions checked from %s' % (len(chains), ', '.join(
+        root for root in roots if root in graph)))
+    return 1 if found else 0
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    sys.exit(main(sys.argv[1], sys.argv[2:] or ROOTS))
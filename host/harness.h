@@ -0,0 +1,169 @@
+// Drives the sketch on the host. Included at the end of the generated
+// sketch source, so it sees the game's state directly.
+//
+// In play an autopilot follows the ball, holds FIRE now and then to
+// release it and fire the laser, and drops every power-up type onto the
+// paddle in turn. Elsewhere the buttons are mashed at random, which gets
+// through the title and initials entry. After every pushed gameplay
+// frame each brick's corner on the display must match its mask bit.
+// DRAW_CHECKS asserts stop the run on any coordinate off the screen.
+
+#include "host.h"
+
+const unsigned long HOST_POWER_UP_MS = 1500;  // Play between forced drops
+const unsigned long HOST_SPIN_US = 50;        // A loop() that draws nothing
+
+static unsigned long hostMismatches;
+static unsigned long hostDrops;
+static byte hostLevel;
+
+static boolean hostPlaying()
+{
+  return start && initialDraw && !sequence && gamePhase == PHASE_PLAY;
+}
+
+uint8_t hostButtons()
+{
+  static unsigned long lastChange;
+  static uint8_t mashed;
+
+  if (hostPlaying())
+  {
+    //Chase the lowest ball, a little off centre so the spin varies
+    int target = xb;
+    int lowest = yb;
+    for (byte i = 0; i < phase.play.extraCount; i++)
+    {
+      if (phase.play.extraY[i] > lowest)
+      {
+        lowest = phase.play.extraY[i];
+        target = phase.play.extraX[i];
+      }
+    }
+    int centre = xPaddle + paddleWidth / 2 + (int)(millis() / 700 * 7919 % 9) - 4;
+    uint8_t buttons = 0;
+    if (target + 1 < centre - 1)
+    {
+      buttons |= LEFT_BUTTON;
+    }
+    else if (target + 1 > centre + 1)
+    {
+      buttons |= RIGHT_BUTTON;
+    }
+    if (millis() % 400 < 40)
+    {
+      buttons |= A_BUTTON;
+    }
+    return buttons;
+  }
+
+  if (millis() / 50 != lastChange)
+  {
+    lastChange = millis() / 50;
+    mashed = rand();
+    if (rand() % 3)
+    {
+      mashed &= ~(A_BUTTON | B_BUTTON);
+    }
+  }
+  return mashed;
+}
+
+//Drops the next power-up type just above the paddle. Drops are drawn
+//inverted, so they come off the screen and go back on around the spawn.
+static void hostDropPowerUp()
+{
+  static unsigned long lastDrop;
+  static byte type;
+
+  if (!released || millis() - lastDrop < HOST_POWER_UP_MS)
+  {
+    return;
+  }
+  lastDrop = millis();
+  byte w = pgm_read_byte(&DROP_WIDTH[type]);
+  plotDrops();
+  spawnDrop(type, xPaddle + (paddleWidth - w) / 2, 50);
+  plotDrops();
+  type = (type + 1) % DROP_TYPES;
+  hostDrops++;
+}
+
+//Every brick's top left pixel on the display must match its mask bit,
+//unless something that moves is over it
+static boolean hostCovered(int x, int y, int ox, int oy, int w, int h)
+{
+  return ox < x + 8 && ox + w > x && oy < y + 4 && oy + h > y;
+}
+
+static void hostCheckBricks()
+{
+  for (byte row = 0; row < ROWS; row++)
+  {
+    for (byte column = 0; column < COLUMNS; column++)
+    {
+      int x = brickX(row, column);
+      int y = 2 + 6*row;
+      boolean covered = x >= WIDTH || hostCovered(x, y, xb, yb, 2, 2);
+
+      for (byte i = 0; i < phase.play.extraCount; i++)
+      {
+        covered |= hostCovered(x, y, phase.play.extraX[i], phase.play.extraY[i], 2, 2);
+      }
+      for (byte link = phase.play.dropLive; link; link = phase.play.dropNext[link - 1])
+      {
+        covered |= hostCovered(x, y, phase.play.dropX[link - 1], phase.play.dropY[link - 1], 5, 4);
+      }
+      for (byte i = 0; i < phase.play.shotCount; i++)
+      {
+        covered |= hostCovered(x, y, phase.play.shotX[i], phase.play.shotY[i], 1, SHOT_LENGTH);
+      }
+      if (covered)
+      {
+        continue;
+      }
+
+      boolean lit = (hostScreen[y >> 3][x] >> (y & 7)) & 1;
+      boolean standing = (phase.play.bricks[row] >> column) & 1;
+      if (lit != standing && hostMismatches++ < 5)
+      {
+        fprintf(stderr, "level %u row %u column %u: %s on screen, %s in the mask\n",
+                level, row, column, lit ? "lit" : "dark", standing ? "standing" : "gone");
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  long loops = argc > 1 ? atol(argv[1]) : 20000;
+  srand(argc > 2 ? atoi(argv[2]) : 1);
+
+  setup();
+  for (long i = 0; i < loops; i++)
+  {
+    unsigned long pushes = hostPushes;
+    unsigned long started = micros();
+
+    loop();
+    //A loop that only polled the frame clock took time on the device.
+    //Spinning out the last millisecond of a frame takes none here.
+    if (micros() == started && hostPushes == pushes)
+    {
+      hostAdvance(HOST_SPIN_US);
+    }
+    if (hostPlaying())
+    {
+      if (hostPushes != pushes)
+      {
+        hostCheckBricks();
+      }
+      hostDropPowerUp();
+      hostLevel = max(hostLevel, level);
+    }
+  }
+
+  printf("%ld loops, %lus: level %u, %lu power-ups dropped, %lu mismatches\n",
+         loops, millis() / 1000, hostLevel, hostDrops, hostMismatches);
+  return hostMismatches ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <Arduboy.h>
+
+// What the stand-in display controller has been sent, by page and column
+extern unsigned char hostScreen[HEIGHT / 8][WIDTH];
+// Whole display windows filled so far
+extern unsigned long hostPushes;
+
+void hostAdvance(unsigned long us);
+void hostEraseEEPROM();
+
+// Buttons held now, supplied by the harness
+uint8_t hostButtons();
+
+#endif
@@ -0,0 +1,80 @@
+// Host stand-in for the Arduboy 1.1 library, covering the calls the
+// sketch makes. The display is modelled as the controller's RAM, fed
+// through SPI, so partial updates and page strips land where they would
+// on the device.
+#ifndef HOST_ARDUBOY_H
+#define HOST_ARDUBOY_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <EEPROM.h>
+
+#define WIDTH 128
+#define HEIGHT 64
+
+#define LEFT_BUTTON 32
+#define RIGHT_BUTTON 64
+#define UP_BUTTON 128
+#define DOWN_BUTTON 16
+#define A_BUTTON 8
+#define B_BUTTON 4
+
+class ArduboyAudio
+{
+public:
+  static void begin();
+  static void on();
+  static void off();
+  static bool enabled();
+};
+
+class ArduboyCore
+{
+public:
+  static void boot();
+  static void blank();
+  static void idle();
+  static void LCDDataMode();
+  static void LCDCommandMode();
+  static uint8_t buttonsState();
+  static void paintScreen(const unsigned char *image);
+};
+
+class Print
+{
+public:
+  virtual size_t write(uint8_t c) = 0;
+  size_t print(const char *s);
+  size_t print(const __FlashStringHelper *s);
+  size_t print(unsigned int n);
+  size_t print(unsigned long n);
+  size_t print(int n);
+};
+
+class Arduboy : public Print, public ArduboyCore
+{
+public:
+  void begin();
+  void clear();
+  void display();
+  unsigned char *getBuffer();
+  void fillRect(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t color);
+  void setCursor(int16_t x, int16_t y);
+  virtual size_t write(uint8_t c);
+  bool pressed(uint8_t buttons);
+  void setFrameRate(uint8_t rate);
+  bool nextFrame();
+  int cpuLoad();
+
+  ArduboyAudio audio;
+
+protected:
+  unsigned char sBuffer[(HEIGHT * WIDTH) / 8];
+  uint8_t eachFrameMillis;
+  uint8_t lastFrameDurationMs;
+  unsigned long lastFrameStart;
+  unsigned long nextFrameStart;
+  bool postRender;
+};
+
+#endif
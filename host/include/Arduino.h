@@ -0,0 +1,43 @@
+// Host stand-in for the Arduino core: the types, macros and timing
+// calls the sketch uses, with the clock driven by host/arduboy.cpp.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define F_CPU 16000000UL
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+
+#define abs(x) ((x) > 0 ? (x) : -(x))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(amt, low, high) \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 1)
+#define noInterrupts() cli()
+#define interrupts() sei()
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+long random(long howBig);
+long random(long howSmall, long howBig);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+#endif
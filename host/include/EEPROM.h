@@ -0,0 +1,16 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+
+class EEPROMClass
+{
+public:
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  void update(int address, uint8_t value);
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
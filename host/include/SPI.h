@@ -0,0 +1,14 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <stdint.h>
+
+class SPIClass
+{
+public:
+  static uint8_t transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef HOST_INTERRUPT_H
+#define HOST_INTERRUPT_H
+
+// Interrupt handlers are called by host/arduboy.cpp as time passes
+#define ISR(vector) extern "C" void vector(void)
+inline void cli() {}
+inline void sei() {}
+
+#endif
@@ -0,0 +1,20 @@
+// The ATmega32U4 registers the sketch touches, as plain variables
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+
+#define _BV(b) (1 << (b))
+
+extern volatile uint8_t TCCR1A, TCCR1B, DDRC, PORTC;
+extern volatile uint16_t TCNT1;
+extern volatile uint8_t TCCR4A, TCCR4B, TCCR4D, TC4H, OCR4A, OCR4C, TCNT4;
+extern volatile uint8_t TIFR4, TIMSK4;
+
+#define CS10 0
+#define PC7 7
+#define COM4A0 6
+#define TOV4 2
+#define TOIE4 2
+
+#endif
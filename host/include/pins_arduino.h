@@ -0,0 +1 @@
+// Nothing the sketch needs on the host
@@ -0,0 +1,7 @@
+#ifndef HOST_ATOMIC_H
+#define HOST_ATOMIC_H
+
+#define ATOMIC_BLOCK(type) for (int atomicOnce = 1; atomicOnce; atomicOnce = 0)
+#define ATOMIC_RESTORESTATE
+
+#endif
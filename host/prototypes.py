@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+"""Writes a C++ source for the host build from the sketch, the way the
+Arduino builder does: the module headers, a prototype for every function
+defined at file scope, then the sketch itself. Extra files named after the
+sketch are included at the end."""
+import re
+import sys
+
+FUNCTION = re.compile(
+    r'^((?:static\s+)?(?:unsigned\s+|signed\s+|const\s+)?[A-Za-z_]\w*[\s*&]+)'
+    r'([A-Za-z_]\w*)\s*\(([^;{)]*(?:\([^)]*\)[^;{)]*)*)\)\s*\{', re.M)
+KEYWORDS = {'else', 'return', 'if', 'while', 'for', 'switch', 'do'}
+
+
+def main(sketch, headers, extras):
+    source = open(sketch).read()
+    out = ['#include "Arduboy.h"']
+    out += ['#include "%s"' % header for header in headers]
+    for match in FUNCTION.finditer(source):
+        result, name, args = match.groups()
+        if result.split()[-1] in KEYWORDS:
+            continue
+        args = re.sub(r'=[^,]*', '', args)
+        out.append('%s %s(%s);' % (result.strip(), name, args))
+    out.append('#line 1 "%s"' % sketch)
+    out.append(source)
+    out += ['#include "%s"' % extra for extra in extras]
+    print('\n'.join(out))
+
+
+if __name__ == '__main__':
+    headers = [a for a in sys.argv[2:] if a.endswith('.h') and 'breakout_' in a]
+    extras = [a for a in sys.argv[2:] if a not in headers]
+    main(sys.argv[1], headers, extras)